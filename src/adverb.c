@@ -6,6 +6,9 @@
 #include "op_binary.h"
 #include "utils.h"
 #include "error.h"
+#include "thread.h"
+
+#include <pthread.h>
 
 // forward declarations
 K each1(K, K);
@@ -19,11 +22,13 @@ static K eachleft2(K, K, K);
 K over1(K, K);
 K over1Generic(K, K);
 K over1Bool(K, K);
+K over1Chr(K, K);
 K over1Int(K, K);
 K over2(K, K, K);
 K scan1(K, K);
 K scan1Generic(K, K);
-K sumsBools(K);
+K scan1Num(K, K);
+K scan1Bool(K, K);
 K scan2(K, K, K);
 K prior1(K, K);
 K prior2(K, K, K);
@@ -79,6 +84,44 @@ K _eachleft(F2 f, K x, K y){
 
 // each (map)
 
+// parallel each (\p N, N>1): a lambda's items are split into contiguous runs, one pool task each (see par).
+// a task writes only its own slots of r. as serially, the lowest failing item's error is the one reported
+typedef struct {
+    K f, x, y, r;
+    K_int n, tasks, fail;
+    pthread_mutex_t mu;
+    int err, pos; const char *str; char buf[sizeof kerrbuf];
+} Peach;
+
+static void peachTask(void *a, K_int t){
+    Peach *p = a;
+    for (K_int i = t*p->n/p->tasks, e = (t+1)*p->n/p->tasks; i < e && i < __atomic_load_n(&p->fail, __ATOMIC_RELAXED); i++){
+        K r = apply(p->f, 1 + !!p->y, (K[]){item(i, p->x), p->y ? item(i, p->y) : 0});
+        if (!r){
+            pthread_mutex_lock(&p->mu);
+            if (i < p->fail) p->fail = i, p->err = kerrno, p->pos = kerrpos, p->str = kerrstr, memcpy(p->buf, kerrbuf, sizeof kerrbuf);
+            pthread_mutex_unlock(&p->mu);
+            return;
+        }
+        OBJ_PTR(p->r)[i] = r;
+    }
+}
+
+static K peach(K f, K x, K y){
+    K_int n = HDR_COUNT(x);
+    Peach p = {.f = f, .x = x, .y = y, .r = knew(KObjType, n), .n = n, .tasks = MIN(n, 4*nthreads), .fail = n, .mu = PTHREAD_MUTEX_INITIALIZER};
+    memset(OBJ_PTR(p.r), 0, n * sizeof(K));
+    par(p.tasks, peachTask, &p);
+    if (p.fail < n){
+        kerrno = p.err, kerrpos = p.pos, kerrstr = p.str, memcpy(kerrbuf, p.buf, sizeof kerrbuf);
+        unref(p.r);
+        return UNREF_XY(0);
+    }
+    return UNREF_XY(squeeze(p.r));
+}
+
+#define IS_PEACH(f, x) (nthreads > 1 && !kworker && HDR_TYPE(f) == KLambdaType && HDR_COUNT(x) > 1)
+
 K each1(K f, K x){
     if (TAG_TYPE(f) != KOpType) return each1Generic(f, x);
     return TAG_VAL(f)==2  ? neg(x)      // unary - and ~ already iterate,
@@ -87,6 +130,8 @@ K each1(K f, K x){
 }
 
 K each1Generic(K f, K x){
+    if (IS_ATOMIC_LAMBDA(f) && HDR_ARGC(f) == 1 && IS_VECTOR(x)) return apply(f, 1, &x); // f'x is f x
+    if (!IS_TAG(f) && IS_PEACH(f, x)) return peach(f, x, 0);
     K r = knew(KObjType, HDR_COUNT(x));
     FOR_EACH(x){
         K t = item(i, x);
@@ -143,6 +188,8 @@ K each2(K f, K x, K y){
 
 K each2Generic(K f, K x, K y){
     LENGTH_ERROR(HDR_COUNT(x) != HDR_COUNT(y), "f'[x;y]", UNREF_XY(0));
+    if (IS_ATOMIC_LAMBDA(f) && HDR_ARGC(f) == 2 && IS_VECTOR(x) && IS_VECTOR(y)) return apply(f, 2, (K[]){x, y});
+    if (!IS_TAG(f) && IS_PEACH(f, x)) return peach(f, x, y);
     K r = knew(KObjType, HDR_COUNT(x));
     FOR_EACH(x){
         K t = apply(f, 2, (K[]){item(i, x), item(i, y)});
@@ -155,15 +202,77 @@ K each2Generic(K f, K x, K y){
 // over (reduce)
 
 K over1(K f, K x){
-    return (TAG_TYPE(f) == KOpType ? // specialized kernels for some reductions
-            HDR_TYPE(x) == KBoolType && TAG_VAL(f)-1u < 6u ? over1Bool : HDR_TYPE(x) == KIntType && TAG_VAL(f)-1u < 3u ? over1Int : over1Generic : 
-            over1Generic)(f, x);
+    K_int t = HDR_TYPE(x), op = TAG_VAL(f);
+    return (TAG_TYPE(f) != KOpType ? over1Generic : // specialized kernels for the atomic reductions + - * & | =
+            t == KBoolType && (op-1u < 6u || op == 9) ? over1Bool :
+            t == KChrType  && (op == 1 || op == 3 || op == 5 || op == 6) ? over1Chr :
+            t == KIntType  && op-1u < 6u && op != 4 ? over1Int : over1Generic)(f, x);
+}
+
+// specialized kernels
+
+typedef K_char VC16 __attribute__((vector_size(16), aligned(1))); // chr items widened into int lanes
+typedef K_char VC64 __attribute__((vector_size(64), aligned(1)));
+typedef K_int  VI16 __attribute__((vector_size(64), aligned(1)));
+
+#define LANES(V) ((K_int)(sizeof(V)/sizeof((V){}[0])))
+#define ADD(x, y) ((x)+(y))
+#define MUL(x, y) ((x)*(y))
+#define VMIN(x, y) __builtin_elementwise_min((x), (y))
+#define VMAX(x, y) __builtin_elementwise_max((x), (y))
+
+// horizontal reduction of n items at x: fold whole VX chunks lane-wise into a VA accumulator (widening items if VA is wider),
+// then fold the accumulator's lanes and the tail. VE/SE are the vector/scalar forms of the op, id its identity.
+// the op must be associative and commutative, so lane order can't change the result (int +,* wrap like the scalar path)
+#define FOLD(VX, VA, VE, SE, id) ({ \
+    typedef typeof((VX){}[0]) _TX; typedef typeof((VA){}[0]) _TA; \
+    K_int _m = n, _cn = _m / LANES(VX); \
+    VX *_xp = (VX*)x; VA _acc = (VA){} + (_TA)(id); \
+    for (K_int c = 0; c < _cn; c++) _acc = VE(_acc, __builtin_convertvector(_xp[c], VA)); \
+    _TA _j = (id); \
+    FOR(LANES(VA)) _j = SE(_j, _acc[i]); \
+    for (K_int i = _cn*LANES(VX); i < _m; i++) _j = SE(_j, (_TA)((_TX*)x)[i]); \
+    _j; })
+
+// fold n items at x with op (+ * & |; bools: + only). x may point into a list, at a chunk (see reduce)
+static K_int fold(int op, K_char t, K x, K_int n){
+    if (t == KBoolType){ K_int j = 0; FOR((n+63)/64) j += stdc_count_ones(((uint64_t*)x)[i]); return j; } // zero tail
+    if (t == KChrType) switch (op){
+        case 1:  return FOLD(VC16, VI16, ADD, ADD, 0); // + * widen to int, like chr arithmetic
+        case 3:  return FOLD(VC16, VI16, MUL, MUL, 1);
+        case 5:  return FOLD(VC64, VC64, VMIN, MIN, 0xff);
+        default: return FOLD(VC64, VC64, VMAX, MAX, 0);
+    }
+    switch (op){
+        case 1:  return FOLD(VI16, VI16, ADD, ADD, 0);
+        case 3:  return FOLD(VI16, VI16, MUL, MUL, 1);
+        case 5:  return FOLD(VI16, VI16, VMIN, MIN, INT32_MAX); // empty -> identity, as for + - *
+        default: return FOLD(VI16, VI16, VMAX, MAX, INT32_MIN);
+    }
+}
+
+// from parmin items, fold PAR_CHUNK-item chunks as pool tasks (see par), then fold their partials
+typedef struct { int op; K_char t; K x; K_int n, *part; } Reduce;
+
+static void reduceTask(void *a, K_int c){
+    Reduce *p = a;
+    K_int lo = c*PAR_CHUNK;
+    p->part[c] = fold(p->op, p->t, AT(p->t, p->x, lo), MIN(p->n - lo, (K_int)PAR_CHUNK));
 }
 
-// specialized kernels (sumInts is in utils.h)
+static K_int reduce(int op, K x){
+    K_char t = HDR_TYPE(x);
+    K_int n = HDR_COUNT(x), cn = (n + PAR_CHUNK-1) / PAR_CHUNK;
+    if (n < parmin) return fold(op, t, x, n);
+    K_int part[cn];
+    par(cn, reduceTask, &(Reduce){op, t, x, n, part});
+    K_int j = part[0];
+    for (K_int i = 1; i < cn; i++) j = op == 1 || t == KBoolType ? j + part[i] : op == 3 ? j * part[i] : op == 5 ? MIN(j, part[i]) : MAX(j, part[i]);
+    return j;
+}
 
 K over1Bool(K f, K x){
-    K_int j = sumBools(x);
+    K_int j = reduce(1, x);
     switch (TAG_VAL(f)){
     case 1: /* nothing to do */ ; break; // +
     case 2: j = GET_BIT(x,0)*2 - j; break; // -
@@ -171,27 +280,20 @@ K over1Bool(K f, K x){
     case 4: /* fallthrough */
     case 5: j = j == HDR_COUNT(x); break; // * % &. div here is an implementation quirk: it is NYI thru every other path
     case 6: j = j>0; break; // |
+    case 9: j = (j + HDR_COUNT(x) - 1) & 1; break; // = chains xnor: parity of the ones, flipped per step. empty -> 1
     }
     return UNREF_X(TAG(TAG_VAL(f) < 5 ? KIntType : KBoolType, j));
 }
 
-// -/x
-K_int subInts(K x){
-    if (!HDR_COUNT(x)) return 0;
-    K_int j = 2*INT_PTR(x)[0];
-    FOR_EACH(x) j -= INT_PTR(x)[i];
-    return j;
-}
-
-// */x
-K_int mulInts(K x){
-    K_int j = 1;
-    FOR_EACH(x) j *= INT_PTR(x)[i];
-    return j;
+K over1Chr(K f, K x){
+    K_int j = reduce(TAG_VAL(f), x);
+    return UNREF_X(TAG_VAL(f) < 5 ? kint(j) : kchr(j));
 }
 
+// -/x is x[0] minus the sum of the rest
 K over1Int(K f, K x){
-    return UNREF_X(kint(PICK3(TAG_VAL(f)-1, sumInts, subInts, mulInts)(x)));
+    K_int op = TAG_VAL(f);
+    return UNREF_X(kint(op != 2 ? reduce(op, x) : HDR_COUNT(x) ? 2*INT_PTR(x)[0] - reduce(1, x) : 0));
 }
 
 // general cases
@@ -215,15 +317,81 @@ K over2(K f, K x, K y){
 // scan (accumulate)
 
 K scan1(K f, K x){
-    return TAG_TYPE(f)==KOpType && TAG_VAL(f)==1 && HDR_TYPE(x)==KBoolType ? sumsBools(x) : scan1Generic(f, x);
+    K_int t = HDR_TYPE(x), op = TAG_VAL(f);
+    return (TAG_TYPE(f) != KOpType ? scan1Generic : // specialized kernels for the associative atomic scans + * & |
+            t == KBoolType && (op == 1 || op == 5 || op == 6) ? scan1Bool :
+            (t == KChrType || t == KIntType) && (op == 1 || op == 3 || op == 5 || op == 6) ? scan1Num : scan1Generic)(f, x);
 }
 
 // specialized kernels
 
-K sumsBools(K x){
+// shift v up k lanes, filling from z (a splat of the op's identity)
+#define SHIFT1(v, z) __builtin_shufflevector(v, z, 16, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14)
+#define SHIFT2(v, z) __builtin_shufflevector(v, z, 16,16, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13)
+#define SHIFT4(v, z) __builtin_shufflevector(v, z, 16,16,16,16, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11)
+#define SHIFT8(v, z) __builtin_shufflevector(v, z, 16,16,16,16,16,16,16,16, 0, 1, 2, 3, 4, 5, 6, 7)
+
+// inclusive prefix of op E across the 16 lanes of v, in log2(16) shift+op steps
+#define PREFIX16(v, z, E) ({ typeof(v) _v = (v); \
+    _v = E(_v, SHIFT1(_v, z)); _v = E(_v, SHIFT2(_v, z)); _v = E(_v, SHIFT4(_v, z)); E(_v, SHIFT8(_v, z)); })
+
+// running fold of x into r: each 16-item chunk of VX is widened to VA and prefixed in-register, then combined with
+// the carry (a splat of the previous chunk's last lane). whole chunks read/write past n into bucket headroom
+// NB: r may be x (reuse): chunk c is read before it is written
+#define SCAN(VX, VA, E, id) { \
+    VX *_xp = (VX*)x; VA *_rp = (VA*)r, _z = (VA){} + (typeof((VA){}[0]))(id), _c = _z; \
+    for (K_int c = 0, cn = (HDR_COUNT(x)+15)/16; c < cn; c++){ \
+        _rp[c] = E(PREFIX16(__builtin_convertvector(_xp[c], VA), _z, E), _c); \
+        _c = (VA){} + _rp[c][15]; } }
+
+K scan1Num(K f, K x){
+    bool chr = HDR_TYPE(x) == KChrType;
+    K r = chr && TAG_VAL(f) < 5 ? knew(KIntType, HDR_COUNT(x)) : reuse(HDR_TYPE(x), x); // chr + * widen to int
+    if (chr) switch (TAG_VAL(f)){
+        case 1: SCAN(VC16, VI16, ADD,  0);    break;
+        case 3: SCAN(VC16, VI16, MUL,  1);    break;
+        case 5: SCAN(VC16, VC16, VMIN, 0xff); break;
+        case 6: SCAN(VC16, VC16, VMAX, 0);    break;
+    } else switch (TAG_VAL(f)){
+        case 1: SCAN(VI16, VI16, ADD,  0);         break;
+        case 3: SCAN(VI16, VI16, MUL,  1);         break;
+        case 5: SCAN(VI16, VI16, VMIN, INT32_MAX); break;
+        case 6: SCAN(VI16, VI16, VMAX, INT32_MIN); break;
+    }
+    return UNREF_X(r);
+}
+
+// +\bool: 16 bits at a time, each spread across 16 int lanes and prefix-summed
+static K sumsBools(K x){
+    static const VI16 lane = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
     K r = knew(KIntType, HDR_COUNT(x));
-    K_int *ints = INT_PTR(r);
-    FOR_EACH(x) ints[i] = !i ? GET_BIT(x,0) : ints[i-1] + GET_BIT(x,i);
+    uint16_t *xp = (uint16_t*)x; // bool tail invariant: bits past n are 0
+    VI16 *rp = (VI16*)r, z = {}, c = z;
+    for (K_int i = 0, cn = (HDR_COUNT(x)+15)/16; i < cn; i++){
+        rp[i] = PREFIX16((z + xp[i]) >> lane & 1, z, ADD) + c;
+        c = z + rp[i][15];
+    }
+    return UNREF_X(r);
+}
+
+// &\ stays 1 until the first 0 and |\ turns 1 at the first 1: both are a mask split at that bit k
+K scan1Bool(K f, K x){
+    if (TAG_VAL(f) == 1) return sumsBools(x);
+    bool or = TAG_VAL(f) == 6;
+    K_int n = HDR_COUNT(x), k = n;
+    uint64_t *xp = (uint64_t*)x;
+    FOR_WORDS(x){
+        uint64_t w = or ? xp[i] : ~xp[i];
+        if (w){ k = MIN(n, i*64 + (K_int)stdc_trailing_zeros(w)); break; }
+    }
+    K r = reuse(KBoolType, x);
+    uint64_t *rp = (uint64_t*)r;
+    FOR_WORDS(x){
+        K_int b = i*64;
+        uint64_t m = k <= b ? 0 : k >= b+64 ? -1ULL : (1ULL << (k-b)) - 1; // bits below k
+        rp[i] = or ? ~m : m;
+    }
+    zeroBoolTail(r);
     return UNREF_X(r);
 }
 
@@ -247,8 +415,12 @@ K scan2(K f, K x, K y){
 
 // prior (pairwise)
 
+// atomic arith/compare verbs (not %) on bool chr int lists go to the shifted-vector kernel prior() in op_binary.c
+#define IS_PRIOR_KERNEL(f, x) (IS_ATOMIC_BINOP(f) && TAG_VAL(f) && TAG_VAL(f) != 4 && IS_VECTOR(x))
+
 // f':x. x[0] passes through, so -': is deltas
 K prior1(K f, K x){
+    if (IS_PRIOR_KERNEL(f, x)) return prior(TAG_VAL(f), 0, x);
     K r = knew(KObjType, HDR_COUNT(x));
     FOR_EACH(x){
         K t = !i ? item(i, x) : apply(f, 2, (K[]){item(i, x), item(i-1, x)});
@@ -258,7 +430,15 @@ K prior1(K f, K x){
     return UNREF_X( squeeze(r) );
 }
 
+// x f':y. x seeds the first pair: f[y 0;x]
 K prior2(K f, K x, K y){
-    (void)f;
-    NYI_ERROR(1, "prior2", UNREF_XY(0));
+    RANK_ERROR(IS_ATOM(y), "x f': yatom", UNREF_XY(0));
+    if (IS_TAG(x) && TAG_TYPE(x) == HDR_TYPE(y) && IS_PRIOR_KERNEL(f, y)) return prior(TAG_VAL(f), x, y);
+    K r = knew(KObjType, HDR_COUNT(y));
+    FOR_EACH(y){
+        K t = apply(f, 2, (K[]){item(i, y), !i ? ref(x) : item(i-1, y)});
+        if (!t) { HDR_COUNT(r)=i; unref(r); return UNREF_XY(0); }
+        OBJ_PTR(r)[i] = t;
+    }
+    return UNREF_XY( squeeze(r) );
 }
@@ -6,6 +6,7 @@
 #include "adverb.h"
 #include "utils.h"
 #include "error.h"
+#include "jit.h"
 
 // forward declarations
 K index(K, K);
@@ -16,11 +17,13 @@ K applyLambda(K x, int n, K *args){
     RANK_ERROR(HDR_ARGC(x) < n, "too many lambda args", while(n--) unref(args[n]));
     // NYI error is fine, as argc < n is allowed (not an error, returns projection) but not supported yet
     NYI_ERROR(HDR_ARGC(x) > n, "lambda projection", while(n--) unref(args[n]));
+    K r;
+    if (JIT_OF(x) && (r = JIT_FN(x)(args))) return r; // int atom args: nothing to release
     int vn = HDR_VARC(x); // total var count = argc + localc (excl. globalc)
     K locals[vn];
     for (int i = 0; i < vn; i++)
         locals[i] = i < HDR_ARGC(x) ? args[i] : 0;
-    K r = vm(OBJ_PTR(x)[0], OBJ_PTR(x)[1], OBJ_PTR(x)[2], vn, locals);
+    r = vm(OBJ_PTR(x)[0], OBJ_PTR(x)[1], OBJ_PTR(x)[2], vn, locals);
     while (vn--) unref(locals[vn]);
     return r;
 }
@@ -2,12 +2,13 @@
 
 #include "error.h"
 #include "sym.h"
+#include "object.h"
 
 // Error state variables (defined here, declared extern in error.h)
-int kerrno = -1;  // -1 = uninitialized; errors start at 0 (KERR_PARSE)
-int kerrpos = -1;
-const char *kerrstr = "";
-char kerrbuf[LINE_LEN * 2];
+_Thread_local int kerrno = -1;  // -1 = uninitialized; errors start at 0 (KERR_PARSE)
+_Thread_local int kerrpos = -1;
+_Thread_local const char *kerrstr = "";
+_Thread_local char kerrbuf[LINE_LEN * 2];
 
 const char *kerr_names[] = {
     "parse",
@@ -16,18 +17,22 @@ const char *kerr_names[] = {
     "value",
     "rank",
     "nyi",
+    "stack",
 };
 
 void kperror(char *src){
+    kflush(); // what was printed before the error comes first
     fprintf(stderr, "'%s! %s %s\n", kerr_names[kerrno], kerrstr, kerrno == KERR_VALUE ? kerrbuf : "");
     if (kerrno == KERR_PARSE && kerrpos != -1) {
         fprintf(stderr, "    %s\n%*s^\n", src, kerrpos+4, "");
     }
 }
 
-// functions to copy string into kerrbuf in VALUE_ERROR
+// functions to copy string into kerrbuf in VALUE_ERROR. a sym's name is read through symName: pool tasks raise these too
 inline void _copy_sym(K_sym v){
-    _copy_chr(OBJ_PTR(SYMS)[v]);
+    K s = symName(v);
+    _copy_chr(s);
+    unref(s);
 }
 inline void _copy_chr(K x) {
     size_t n = HDR_COUNT(x);
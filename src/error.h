@@ -5,11 +5,11 @@
 
 #include "krua.h"
 
-// Error state (errno-style)
-extern int kerrno;
-extern int kerrpos;
-extern const char *kerrstr;
-extern char kerrbuf[512];
+// Error state (errno-style). per thread, so pool tasks fail independently
+extern _Thread_local int kerrno;
+extern _Thread_local int kerrpos;
+extern _Thread_local const char *kerrstr;
+extern _Thread_local char kerrbuf[512];
 extern const char *kerr_names[];
 void kperror(char *src);
 extern void _copy_sym(K_sym v), _copy_chr(K v); // used in VALUE_ERROR
@@ -21,6 +21,7 @@ enum {
     KERR_VALUE,        // Value error (undefined var, etc)
     KERR_RANK,         // Rank error (too many )
     KERR_NYI,          // Not yet implemented
+    KERR_STACK,        // Stack error (calls nested too deep)
 };
 
 #define PARSE_ERROR(p, pos, e, cleanup) \
@@ -10,9 +10,12 @@
 #include "file.h"
 #include "sym.h"
 #include "error.h"
+#include "thread.h"
+#include "jit.h"
+#include "image.h"
 
 const char OPS[] = ":+-*%&|<>=@.!,?#_~$^      '/\\";
-const char KEYWORDS_STRING[] = ": flip neg first % where | < > group type value til , ? count _ not $ ^ csv";
+const char KEYWORDS_STRING[] = ": flip neg first % where | < > group type value til , ? count _ not string ^ csv";
 
 #define IS_ADVERB(x) (x-ADVERB_START < 6u)
 #define IS_POSTFIX_ADVERB(x) ({K_char _p=(x); IS_CLASS(TOK_POSTFIX, _p) && HDR_ADVERB(OBJ_PTR(postfix)[_p & 31]);})
@@ -20,9 +23,6 @@ const char KEYWORDS_STRING[] = ": flip neg first % where | < > group type value
 K GLOBALS = 0;
 K KEYWORDS = 0;
 
-// forwards declarations
-K load(K, K);
-
 // K bytecode:
 // class  index
 // 0      0  - 31: apply unary operator
@@ -32,17 +32,54 @@ K load(K, K);
 // 4      128-159: get variable(local/arg/global)
 // 5      160-191: set variable
 // 6      192-223: ?
-// 7      224-255: special operations (enlist, pop)
+// 7      224-255: special operations (pop, enlist, move, fuse, fold, const+binary, get+unary, int ops, unfused, wide)
+// a const/var index past 31 doesn't fit: OP_WIDE, then the class plus its top 5 bits, then its low byte
+
+// placeholder token ranges for reduced token
+enum {
+    TOK_PAREN   = 0x40,
+    TOK_BRACKET = 0xc0,
+    TOK_POSTFIX = 0xe0,
+    TOK_WIDE    = 0xa0, // var (+1 const) index past 31, then 3 bytes of 5 index bits, all in this class (see tokRef)
+};
+#define TOK_LEN(p) (IS_CLASS(TOK_WIDE, *(p)) ? 4 : 1)
 
 // helper to append to a potentially-unallocated generic list
-static K_char appendObj(K *v, K x){
+static K_int appendObj(K *v, K x){
     *v = *v ? joinObj(*v, x) : k1(x);
     return HDR_COUNT(*v) - 1;
 }
 
-// append a K value to consts lists and return the bytecode+index
-static K_char addConst(K *consts, K x){
-    return OP_CONST + appendObj(consts, x);
+// write a var/const token. nothing else token() emits is in TOK_WIDE's class, so passes can step over wide ones
+static K_char *tokRef(K_char *tok, bool cnst, K_int i){
+    if (i < 32) *tok++ = (cnst ? OP_CONST : OP_GET_VAR) + i;
+    else *tok++ = TOK_WIDE + cnst, *tok++ = TOK_WIDE + (i >> 10), *tok++ = TOK_WIDE + (i >> 5 & 31), *tok++ = TOK_WIDE + (i & 31);
+    return tok;
+}
+
+// a token as rpn emits it: the byte, or for a wide token its class << 16 | index (see expandSwitch)
+static K_int unit(K_char *p){
+    if (!IS_CLASS(TOK_WIDE, *p)) return *p;
+    return (*p == TOK_WIDE ? OP_GET_VAR : OP_CONST) << 16 | (p[1] & 31) << 10 | (p[2] & 31) << 5 | (p[3] & 31);
+}
+
+// write a const/get/set instruction for index i
+static K_char *emit(K_char *d, K_char class, K_int i){
+    if (i < 32) *d++ = class + i;
+    else *d++ = OP_WIDE, *d++ = class + (i >> 8), *d++ = i & 255;
+    return d;
+}
+
+// index of the const/get/set instruction of this class at p, -1 if it's something else
+static K_int operand(K_char *p, K_char class){
+    if (IS_CLASS(class, *p)) return *p & 31;
+    return *p == OP_WIDE && IS_CLASS(class, p[1]) ? WIDE_INDEX(p) : -1;
+}
+
+// bytes in the instruction at p. a fuse header counts alone: its segment follows as plain instructions
+static K_int oplen(K_char *p){
+    if (*p == OP_WIDE || *p == OP_CONST_BINARY || *p == OP_GET_UNARY) return 3;
+    return 1 + (*p == OP_ENLIST || *p == OP_MOVE_VAR || *p == OP_FUSE || *p == OP_FOLD || *p == OP_UNFUSED);
 }
 
 static K numbers(K_char *src, K_int len, K_int count){
@@ -86,6 +123,37 @@ static K_int findClose(K_char *s, K_int i, K_int n, K_char open, K_char close) {
     return i;
 }
 
+// a lambda is atomic if its body only passes args and locals through atomic verbs (- ~ unary, + - * & | < > = binary)
+// and atom constants. then f'x is f x, so each can lift it to one call on the whole list (see each1Generic).
+// the stack is interpreted abstractly as a bitset (top at bit 0) of which values derive from an arg, so a result
+// that ignores its args ({[x]1}) stays per-item
+static bool atomic(K f, K_char argc, K_char varc){
+    if (varc > 63) return 0; // vars are bits of d (argc <= varc)
+    K x = OBJ_PTR(f)[0], consts = OBJ_PTR(f)[2];
+    K_char *b = CHR_PTR(x);
+    uint64_t s = 0, d = (1ULL << argc) - 1; // stack, vars
+    K_int sp = 0;
+    for (K_int i = 0, n = HDR_COUNT(x); i < n; i++){
+        K_char j = b[i] & 31;
+        switch (b[i] >> 5){
+        case 0: if ((j != 2 && j != 17) || !sp) return 0; break;
+        case 1: if (!j || j == 4 || j > 9 || sp < 2) return 0; s = (s >> 2) << 1 | ((s | s >> 1) & 1), --sp; break;
+        case 3: if (!IS_TAG(OBJ_PTR(consts)[j])) return 0; s <<= 1, ++sp; break;
+        case 4: if (j >= varc) return 0; s = s << 1 | (d >> j & 1), ++sp; break;
+        case 5: if (j >= varc || !sp) return 0; d = (d & ~(1ULL << j)) | (s & 1) << j; break;
+        case 7: if (j == 0){ if (sp) s >>= 1, --sp; break; }
+                if (j == 3){ ++i; break; } // fuse header
+                if (j == 5 && IS_TAG(OBJ_PTR(consts)[b[i+1]]) && b[i+2] && b[i+2] != 4 && b[i+2] < 10 && sp){ i += 2; break; } // const+binary: top keeps its bit
+                if (j == 6 && b[i+1] < varc && (b[i+2] == 2 || b[i+2] == 17)){ s = s << 1 | (d >> b[i+1] & 1), ++sp, i += 2; break; } // get+unary
+                if (j == 2 && b[i+1] < varc){ j = b[++i]; s = s << 1 | (d >> j & 1), ++sp; break; }
+                return 0;
+        default: return 0;
+        }
+        if (sp > 63) return 0;
+    }
+    return sp && (s & 1);
+}
+
 static K lambda(K_char *src, K_int start, K_int end){
     // ensure params list exists
     PARSE_ERROR(src[start+1] != '[', start+1, "lambda must have params {[a;b]a+b}", );
@@ -99,16 +167,22 @@ static K lambda(K_char *src, K_int start, K_int end){
     K_char argc = HDR_COUNT(vars);
     K body = kstr((src + end) - pend - 1, pend + 1);
     locals(body, &vars);
+    PARSE_ERROR(HDR_COUNT(vars) > LOCALS_MAX, start, "too many locals", (unref(vars), unref(body)));
     K_char varc = HDR_COUNT(vars);
     
-    K f = load(body, vars);
-    if (!f) return 0;
+    K l = load(body, vars);
+    if (!l) return 0;
     
+    K f = knew(KObjType, 5); // (bytecode;vars;consts;source), and its native code past the count (see JIT_OF)
+    HDR_COUNT(f) = 4;
+    FOR(3) OBJ_PTR(f)[i] = OBJ_PTR(l)[i], OBJ_PTR(l)[i] = 0; // take them: only the body goes
+    unref(l);
     HDR_ARGC(f) = argc;
     HDR_VARC(f) = varc;
     HDR_TYPE(f) = KLambdaType;
-    unref(OBJ_PTR(f)[3]);
+    HDR_ATTR(OBJ_PTR(f)[0]) = atomic(f, argc, varc);
     OBJ_PTR(f)[3] = kstr(end - start + 1, src + start);
+    JIT_OF(f) = jit(f);
     return f;
 }
 
@@ -130,13 +204,13 @@ static K_int booltoken(K_int n, K_int i, K_char *src){
 // a source constant/literal is appended to 'consts'
 // variable names are appended to 'vars'
 // NB: does not consume (unref) arg 'x' 
-// NB: constant/variable tokens are the same value as the bytecode that's eventually generated for them
+// NB: constant/variable tokens are the same value as the bytecode that's eventually generated for them, bar wide ones
 // TODO: write array of source code offsets which corresponds to each token for error reporting
 // '-' opening a negative literal: a digit follows. scoped to token(): uses i, n from scope
 K token(K x, K *vars, K *consts){
     K_int n = HDR_COUNT(x);
-    // token stream to return
-    K r = knew(KChrType, n);
+    // token stream to return. a wide token takes 4 bytes for 1 char, and modified assignment a+:y repeats a (a:a+y)
+    K r = knew(KChrType, 4*n);
     
     // loop over the source and generate tokens
     K_int i = 0;
@@ -147,22 +221,25 @@ K token(K x, K *vars, K *consts){
         K_int t0 = i;
 
 #define ISNEGDIGIT(s) (s[i] == '-' && i+1 < n && ISDIGIT(s[i+1]))
+#define REF(c, i) { K_int _i = (i); \
+        PARSE_ERROR(_i >= (c ? CONSTS_MAX : VARS_MAX), t0, c ? "too many constants" : "too many variables", unref(r)); tok = tokRef(tok, c, _i); }
         if (ISALPHA(src[i])){
             // variables + keywords
             do ++i; while (i < n && ISALPHA(src[i]));
             K_int j;
             K_sym sym = internSym(i-t0, src+t0);
-            *tok++ = (j=findSym(KEYWORDS, sym)) < HDR_COUNT(KEYWORDS) ? j : OP_GET_VAR + addSym(vars, sym);
+            if ((j=findSym(KEYWORDS, sym)) < HDR_COUNT(KEYWORDS)) *tok++ = j;
+            else REF(0, addSym(vars, sym));
         } else if (src[i] == '`'){
             ++t0;
             do ++i; while (i < n && (src[i] == '`' || ISALPHA(src[i])));
             K x = syms4chrs(cutStr(kstr(i-t0, src+t0), '`'));
-            *tok++ = addConst(consts, HDR_COUNT(x) == 1 ? UNREF_X(item(0, x)) : x);
+            REF(1, appendObj(consts, HDR_COUNT(x) == 1 ? UNREF_X(item(0, x)) : x));
         } else if (ISDIGIT(src[i]) || (ISNEGDIGIT(src) && (i==0 || !(isalnum(src[i-1]) || strchr(")]}\"", src[i-1]))))){
             K_int count;
             if ((count = booltoken(n, i, src))){
                 K x = count == 1 ? TAG(KBoolType, src[i]=='1') : eql(kchr('1'), kstr(count, src+i));
-                *tok++ = addConst(consts, x);
+                REF(1, appendObj(consts, x));
                 i += count + 1;
             } else {
                 // numbers ('-' opens a negative literal unless it subtracts from a preceding value)
@@ -172,27 +249,27 @@ K token(K x, K *vars, K *consts){
                         count++, i += (src[i] == '-');   // new element; swallow its sign so the loop just sees digits
                 } while (i < n && (ISDIGIT(src[i]) || src[i] == ' '));
                 while (src[i-1] == ' ') --i;
-                *tok++ = addConst(consts, numbers(src+t0, i-t0, count));
+                REF(1, appendObj(consts, numbers(src+t0, i-t0, count)));
             }
         } else if (src[i] == '"'){
             // string
             ++t0;
             do ++i; while (i < n && src[i] != '"');
             PARSE_ERROR(i == n, i, "unclosed string", unref(r));
-            *tok++ = addConst(consts, (i-t0) == 1 ? kchr(src[t0]) : kstr(i-t0, src+t0));
+            REF(1, appendObj(consts, (i-t0) == 1 ? kchr(src[t0]) : kstr(i-t0, src+t0)));
             ++i;
         } else if (src[i] == '{'){
             K_int end = findClose(src, i, n, '{', '}');
             PARSE_ERROR(end == n, i, "unclosed lambda", unref(r));
             K res = lambda(src, i, end);
             if (!res) return UNREF_R(0);
-            *tok++ = addConst(consts, res);
+            REF(1, appendObj(consts, res));
             i = end + 1;
         } else if (src[i] == '(' || src[i] == ')'){
             K_int j = next(n, i+1, src);
             if (src[i] == '(' && j < n && src[j] == ')'){
                 // add empty list literal const ()
-                *tok++ = addConst(consts, knew(KObjType, 0));
+                REF(1, appendObj(consts, knew(KObjType, 0)));
                 i = j + 1;
             } else {
                 *tok++ = src[i++];
@@ -202,45 +279,45 @@ K token(K x, K *vars, K *consts){
             PARSE_ERROR((unsigned)src[i] - 32 > 94u, i, "invalid token", unref(r));
             char *op = strchr(OPS, src[i]);
             K_char t = op ? op - OPS : src[i];
+            K_int w = tok > CHR_PTR(r) && IS_CLASS(TOK_WIDE, tok[-1]) ? 4 : 1; // a wide token ends in index bytes
             if (IS_ADVERB(t) && i+1 < n && src[i+1] == ':') t += 3, ++i;
+            // modified assignment: a,:y -> a:a,y. the plain set/join then lets load() move a into the join (see moves)
+            else if (t && IS_OPERATOR(t) && i+1 < n && src[i+1] == ':' && tok > CHR_PTR(r) && (IS_CLASS(OP_GET_VAR, tok[-1]) || tok[-w] == TOK_WIDE)){
+                *tok = 0, MEMCPY(tok+1, tok-w, w), tok += w+1, ++i;
+            }
             *tok++ = t;
             ++i;
         }
+#undef REF
 #undef ISNEGDIGIT
     }
     HDR_COUNT(r) = tok - CHR_PTR(r);
     return r;
 }
 
-// placeholder token ranges for reduced token
-enum {
-    TOK_PAREN   = 0x40,
-    TOK_BRACKET = 0xc0,
-    TOK_POSTFIX = 0xe0,
-};
-
 // in-place reverse of K list
 static void reverse(K r){
     K o, *s=OBJ_PTR(r), *e=OBJ_PTR(r)+HDR_COUNT(r)-1; while (s<e){o=*s;*s++=*e;*e--=o;};
 }
-// in-place reverse of K_char list
-static void reverseChr(K r){
-    K_char o, *s=CHR_PTR(r), *e=CHR_PTR(r)+HDR_COUNT(r)-1; while (s<e){o=*s;*s++=*e;*e--=o;};
+// in-place reverse of K_int list
+static void reverseInt(K r){
+    K_int o, *s=INT_PTR(r), *e=INT_PTR(r)+HDR_COUNT(r)-1; while (s<e){o=*s;*s++=*e;*e--=o;};
 }
 
 static K expandPostfix(K x, K fenced, K postfix);
 
-static K expandSwitch(K_char c, K fenced, K postfix){
+static K expandSwitch(K_int c, K fenced, K postfix){
     if (IS_CLASS(TOK_PAREN, c)) return compile(0, ref(OBJ_PTR(fenced)[c & 31]), 1);
     if (IS_CLASS(TOK_POSTFIX, c)) return expandPostfix(OBJ_PTR(postfix)[c & 31], fenced, postfix);
+    if (c > 255) return joinTag(kc2(OP_WIDE, (c >> 16) + (c >> 8 & 31)), c & 255); // wide unit (see rpn)
     return kc1(c);
 }
 
 static K expandPostfix(K x, K fenced, K postfix){
     K_char *b = CHR_PTR(x);
-    K r = IS_PRIMITIVE(*b) ? kc1(OP_VERB + *b) : expandSwitch(*b, fenced, postfix);
+    K r = IS_PRIMITIVE(*b) ? kc1(OP_VERB + *b) : expandSwitch(unit(b), fenced, postfix);
     if (!r) return 0;
-    for (K_int i = 1, n = HDR_COUNT(x); i < n; i++) {
+    for (K_int i = TOK_LEN(b), n = HDR_COUNT(x); i < n; i++) {
         if (IS_ADVERB(b[i])) {
             r = joinTag(r, OP_VERB + b[i]);
         } else {
@@ -252,40 +329,43 @@ static K expandPostfix(K x, K fenced, K postfix){
     return r;
 }
 
+// emits units (see unit): tokens, bar wide ones, are already a byte of bytecode
 static K rpn(K x, K postfix){
     K_int i = 0, j = 0, n = HDR_COUNT(x);
-    K r = knew(KChrType, n * 2);
-    K_char *xp = CHR_PTR(x), *rp = CHR_PTR(r);
-    while (i + 1 < n){
-        K_char x = xp[i], y = xp[i+1];
+    K r = knew(KIntType, n * 2);
+    K_char *xp = CHR_PTR(x);
+    K_int *rp = INT_PTR(r);
+    while (i + TOK_LEN(xp+i) < n){
+        K_int w = TOK_LEN(xp+i), u = unit(xp+i);
+        K_char x = xp[i], y = xp[i+w];
         if (IS_PRIMITIVE(x) || IS_POSTFIX_ADVERB(x)){ // +x
             rp[j++] = x; i++;
         } else if (IS_OPERATOR(y) || IS_POSTFIX_ADVERB(y)){ // x+
             int adverb = !IS_OPERATOR(y);
             if (adverb) HDR_ADVERB(OBJ_PTR(postfix)[y&31])++;
-            if (!y && IS_CLASS(OP_GET_VAR, x))
-                rp[j++] = OP_SET_VAR + x % 32;
+            if (!y && (IS_CLASS(OP_GET_VAR, x) || x == TOK_WIDE))
+                rp[j++] = u + (OP_SET_VAR - OP_GET_VAR) * (w > 1 ? 1 << 16 : 1);
             else
-                rp[j++] = adverb ? y : OP_BINARY + y, rp[j++] = x;
-            i += 2;
+                rp[j++] = adverb ? y : OP_BINARY + y, rp[j++] = u;
+            i += w + 1;
         } else { // x y
-            rp[j++] = OP_BINARY + 10, rp[j++] = x; i++;
+            rp[j++] = OP_BINARY + 10, rp[j++] = u; i += w;
         }
     }
     if (i < n){
         K_char c = xp[i];
         if (IS_POSTFIX_ADVERB(c)) HDR_ADVERB(OBJ_PTR(postfix)[c&31])--;
-        rp[j++] = IS_PRIMITIVE(c) ? OP_VERB + c : c;
+        rp[j++] = IS_PRIMITIVE(c) ? OP_VERB + c : unit(xp+i);
     }
     HDR_COUNT(r) = j;
-    reverseChr(r);
+    reverseInt(r);
     return r;
 }
 
 static K expandTokens(K x, K fenced, K postfix){
     K r = knew(KObjType, HDR_COUNT(x));
     FOR_EACH(x){
-        K t = expandSwitch(CHR_PTR(x)[i], fenced, postfix);
+        K t = expandSwitch(INT_PTR(x)[i], fenced, postfix);
         if (!t) { HDR_COUNT(r)=i; return UNREF_R(0);}
         OBJ_PTR(r)[i] = t;
     }
@@ -314,14 +394,16 @@ static K reducePostfix(K x, K *postfix){
     K_int j = 0;
     K_char *tok = CHR_PTR(x);
     for (K_int i = 0, n = HDR_COUNT(x); i < n; ){
-        if (i < n-1 && (IS_CLASS(TOK_BRACKET, tok[i+1]) || IS_ADVERB(tok[i+1]))){
-            K_int start = i++;
+        K_int w = TOK_LEN(tok+i);
+        if (i+w < n && (IS_CLASS(TOK_BRACKET, tok[i+w]) || IS_ADVERB(tok[i+w]))){
+            K_int start = i;
+            i += w;
             do ++i; while (i<n && (IS_CLASS(TOK_BRACKET, tok[i]) || IS_ADVERB(tok[i])));
             K body = kstr(i - start, tok + start);
             HDR_ADVERB(body) = IS_ADVERB(tok[i-1]);
             tok[j++] = TOK_POSTFIX + appendObj(postfix, body);
         } else {
-            tok[j++] = tok[i++];
+            while (w--) tok[j++] = tok[i++];
         }
     }
     HDR_COUNT(x) = j;
@@ -387,14 +469,230 @@ static bool balanced(K tokens){
     return 1;
 }
 
+// pure verbs: no side effects, so they can run at compile time on constants. unary - * & ! , # ~ and binary
+// + - * & | < > = @ , ? # _ ~ ^ (value and csv read files; the rest are nyi)
+#define IS_PURE_UNARY(j)  (0x2b02cu >> (j) & 1)
+#define IS_PURE_BINARY(j) (0xbe7eeu >> (j) & 1)
+// constants a pure verb may fold: data, not lambdas (@ would call them) or verbs
+#define IS_DATA(x) (IS_TAG(x) ? TAG_TYPE(x) < KOpType : HDR_TYPE(x) < K_GENERIC_TYPES_START)
+// a fold's result is a constant for the life of the code (and of an image or a cached load): atoms, or lists up to
+// FOLD_MAX bytes. the verbs that can make a list far larger than their constants (!n, n#y, &x) aren't even run past it
+#define IS_SMALL(x) (IS_TAG(x) || XBYTES(x) <= FOLD_MAX)
+#define IS_SMALL_INT(x) (TAG_TYPE(x) == KIntType && (uint32_t)TAG_VAL(x) + FOLD_MAX/8 <= FOLD_MAX/4)
+#define FOLDS_SMALL_UNARY(j, x) ((j) == 12 ? IS_SMALL_INT(x) : (j) != 5 || (!IS_TAG(x) && HDR_TYPE(x) == KBoolType))
+#define FOLDS_SMALL_BINARY(j, x) ((j) != 15 || IS_SMALL_INT(x))
+
+// constant folding: a pure verb over constant pushes runs now and becomes one push of its result. so does an enlist
+// of constants. a push popped straight away (a const, a verb, a local) is dropped. rewrites in place, as the code only
+// shrinks: ins holds the output offset of each instruction, so the tail can be matched after every one is copied.
+// a fold that errors is left to raise at run time. consts no longer referenced are then dropped and the rest renumbered
+static K peephole(K x, K *consts, K_char varc){
+    K_int n = HDR_COUNT(x), k = 0, ins[n+1];
+    K_char *b = CHR_PTR(x), *d = b;
+    K *c = *consts ? OBJ_PTR(*consts) : 0;
+    bool folded = 0;
+    #define CONST_AT(p) ({K_int _i = operand(b+ins[p], OP_CONST); _i >= 0 && IS_DATA(c[_i]) ? c[_i] : 0;})
+    for (K_int i = 0; i < n; i++){
+        ins[k++] = d - b;
+        *d++ = b[i];
+        if (b[i] == OP_ENLIST) *d++ = b[++i];
+        else if (b[i] == OP_WIDE) *d++ = b[++i], *d++ = b[++i];
+        while (k){ // fold the tail while it matches: a dropped push can leave no code
+            K_char o = b[ins[k-1]], j = o & 31;
+            K r = 0;
+            K_int m = 0; // instructions the fold replaces
+            K_char *p = k > 1 ? b + ins[k-2] : 0;
+            if (o == OP_POP && p && (operand(p, OP_CONST) >= 0 || (IS_CLASS(OP_VERB, *p) && IS_PRIMITIVE(*p & 31)) || (unsigned)operand(p, OP_GET_VAR) < varc)){
+                d = b + ins[k -= 2];
+                continue;
+            }
+            if (!c || HDR_COUNT(*consts) >= CONSTS_MAX) break;
+            if (IS_CLASS(OP_UNARY, o) && IS_PURE_UNARY(j) && k > 1 && CONST_AT(k-2) && FOLDS_SMALL_UNARY(j, CONST_AT(k-2)))
+                m = 2, r = unary_op[j](ref(CONST_AT(k-2)));
+            else if (IS_CLASS(OP_BINARY, o) && IS_PURE_BINARY(j) && k > 2 && CONST_AT(k-2) && CONST_AT(k-3)
+                && FOLDS_SMALL_BINARY(j, CONST_AT(k-2)))
+                m = 3, r = binary_op[j](ref(CONST_AT(k-2)), ref(CONST_AT(k-3)));
+            else if (o == OP_ENLIST && k > (j = b[ins[k-1]+1])){
+                bool all = 1;
+                FOR(j) all &= !!CONST_AT(k-2-i);
+                if (!all) break;
+                r = knew(KObjType, j), m = j+1;
+                FOR(j) OBJ_PTR(r)[i] = ref(CONST_AT(k-2-i));
+                r = squeeze(r);
+            }
+            if (!r) break;
+            if (o != OP_ENLIST && !IS_SMALL(r)){ unref(r); break; } // an enlist is no larger than its source
+            if (HDR_COUNT(*consts) >= 32 && d - b - ins[k-m] < 3){ unref(r); break; } // a wide push mustn't outgrow what it replaces
+            d = b + ins[k -= m];
+            ins[k++] = d - b;
+            d = emit(d, OP_CONST, appendObj(consts, r));
+            c = OBJ_PTR(*consts), folded = 1;
+        }
+    }
+    #undef CONST_AT
+    HDR_COUNT(x) = d - b;
+    if (!folded) return x;
+    K_int map[HDR_COUNT(*consts)], j;
+    FOR(HDR_COUNT(*consts)) map[i] = -1;
+    FOR(k) if ((j = operand(b+ins[i], OP_CONST)) >= 0) map[j] = 0;
+    K r = knew(KObjType, 0);
+    FOR(HDR_COUNT(*consts)) if (!map[i]) map[i] = HDR_COUNT(r), r = joinObj(r, ref(c[i]));
+    FOR(k) if ((j = operand(b+ins[i], OP_CONST)) >= 0){ // renumbering only lowers an index: a wide one stays wide
+        K_char *p = b + ins[i];
+        if (*p == OP_WIDE) p[1] = OP_CONST + (map[j] >> 8), p[2] = map[j] & 255;
+        else *p = OP_CONST + map[j];
+    }
+    unref(*consts);
+    *consts = r;
+    return x;
+}
+
+// ownership transfer: rewrite the last read of a var before its reassignment (or, for locals, before return)
+// as OP_MOVE_VAR, which hands the value to the stack without a ref. the consumer then sees refcount 0 and
+// reuse()/kextend() work in place, so x:x+1 and a:a,y stop copying. bytecode is branch-free, so one linear pass finds them.
+// globals outlive errors, so a global is only moved into a join assigned straight back (a:a,y): join can't fail
+// only the compact forms are tracked: a var's index fixes its form, and OP_MOVE_VAR's operand is a byte
+static K moves(K x, K_char varc){
+    K_int n = HDR_COUNT(x), m = 0, last[32];
+    K_char *b = CHR_PTR(x);
+    bool mv[n+1];
+    memset(mv, 0, n+1);
+    FOR(32) last[i] = -1;
+    for (K_int i = 0; i < n; i += oplen(b+i)){
+        K_char v = b[i] & 31;
+        if (IS_CLASS(OP_GET_VAR, b[i])) last[v] = i;
+        else if (IS_CLASS(OP_SET_VAR, b[i]) && last[v] >= 0){
+            K_int j = last[v];
+            m += mv[j] = v < varc || (j+2 == i && b[j+1] == OP_BINARY+13);
+            last[v] = -1;
+        }
+    }
+    FOR(MIN(varc, 32)) if (last[i] >= 0) m += mv[last[i]] = 1;
+    if (!m) return x;
+    K r = knew(KChrType, n + m);
+    K_char *d = CHR_PTR(r);
+    FOR(n){
+        if (mv[i]) *d++ = OP_MOVE_VAR;
+        *d++ = mv[i] ? b[i] & 31 : b[i];
+    }
+    return UNREF_X(r);
+}
+
+// compare-reduce: a comparison < > = straight into +/ &/ |/ (verb, over, apply 1) becomes OP_FOLD, cmp | op<<4.
+// the vm then counts or any/alls the compare without making its bitmap (see cmpOver)
+static K folds(K x){
+    K_int n = HDR_COUNT(x), m = 0;
+    K_char *b = CHR_PTR(x);
+    for (K_int i = 0; i+3 < n; i += oplen(b+i)){
+        K_char c = b[i] & 31, o = b[i+1] - OP_VERB;
+        if (IS_CLASS(OP_BINARY, b[i]) && c - 7u < 3u && (o == 1 || o == 5 || o == 6) && b[i+2] == OP_VERB + ADVERB_START + 1 && b[i+3] == OP_N_ARY + 1)
+            b[i] = OP_FOLD, b[i+1] = c | o << 4, i += 3, ++m;
+    }
+    if (!m) return x;
+    K r = knew(KChrType, n - 2*m);
+    K_char *d = CHR_PTR(r);
+    for (K_int i = 0; i < n; i++){
+        *d++ = b[i];
+        if (b[i] == OP_ENLIST || b[i] == OP_MOVE_VAR) *d++ = b[++i];
+        else if (b[i] == OP_WIDE) *d++ = b[++i], *d++ = b[++i];
+        else if (b[i] == OP_FOLD) *d++ = b[++i], i += 2;
+    }
+    return UNREF_X(r);
+}
+
+// atomic ops a fused segment may contain: unary - ~, binary + - * & | < > =
+#define IS_FUSABLE(c) ((IS_CLASS(OP_UNARY, c) && ((c&31) == 2 || (c&31) == 17)) || (IS_CLASS(OP_BINARY, c) && (c&31) && (c&31) != 4 && (c&31) < 10))
+
+// loop fusion: prefix each maximal tree of >=2 atomic ops over var/const leaves with OP_FUSE, len. the vm then runs
+// it a slice at a time (see fuse), so intermediates stay in L1 instead of each op making a full pass and temporary.
+// a tree's bytecode is contiguous: simulate the stack, tracking where each value's subtree starts and its op count
+static K fusion(K x){
+    K_int n = HDR_COUNT(x), sp = 0, m = 0, st[STACK_SIZE], ops[STACK_SIZE];
+    K_char *b = CHR_PTR(x), len[n+1];
+    memset(len, 0, n+1);
+    for (K_int i = 0; i <= n; i++){
+        K_char c = i < n ? b[i] : OP_POP; // flush at the end
+        if (sp < STACK_SIZE && (IS_CLASS(OP_GET_VAR, c) || IS_CLASS(OP_CONST, c) || c == OP_MOVE_VAR)){
+            st[sp] = i, ops[sp++] = 0, i += c == OP_MOVE_VAR;
+            continue;
+        }
+        if (IS_FUSABLE(c) && sp > IS_CLASS(OP_BINARY, c)){
+            if (IS_CLASS(OP_BINARY, c)) --sp, ops[sp-1] += ops[sp];
+            ++ops[sp-1];
+            continue;
+        }
+        bool f = c == OP_FOLD && sp > 1; // a fold's result is an atom: it can only be the root of its tree
+        if (f) --sp, ops[sp-1] += ops[sp] + 1;
+        for (K_int k = 0; k < sp; k++){ // trees left on the stack weren't consumed by a fusable op: they're maximal
+            K_int e = k+1 < sp ? st[k+1] : i + 2*f;
+            if (ops[k] > 1 && e - st[k] < 256) len[st[k]] = e - st[k], ++m;
+        }
+        sp = 0, i += i < n ? oplen(b+i) - 1 : 0; // wide pushes aren't leaves: they end the trees too
+    }
+    if (!m) return x;
+    K r = knew(KChrType, n + 2*m);
+    K_char *d = CHR_PTR(r);
+    FOR(n){
+        if (len[i]) *d++ = OP_FUSE, *d++ = len[i];
+        *d++ = b[i];
+    }
+    return UNREF_X(r);
+}
+
+// superinstructions: const then binary (1+x) and get then unary (-x) run as one op, saving a dispatch. last pass,
+// so the passes before only see plain ops. fused segments are left as they are: fuse() interprets them itself
+static K supers(K x){
+    K_int n = HDR_COUNT(x), m = 0;
+    K_char *b = CHR_PTR(x);
+    #define STEP(i) (b[i] == OP_FUSE ? 2 + b[i+1] : oplen(b+i))
+    for (K_int i = 0; i < n; i += STEP(i))
+        m += i+1 < n && ((IS_CLASS(OP_CONST, b[i]) && IS_CLASS(OP_BINARY, b[i+1])) || (IS_CLASS(OP_GET_VAR, b[i]) && IS_CLASS(OP_UNARY, b[i+1])));
+    if (!m) return x;
+    K r = knew(KChrType, n + m);
+    K_char *d = CHR_PTR(r);
+    for (K_int i = 0, s; i < n; i += s){
+        s = STEP(i);
+        if (i+1 < n && IS_CLASS(OP_CONST, b[i]) && IS_CLASS(OP_BINARY, b[i+1])) *d++ = OP_CONST_BINARY, *d++ = b[i] & 31, *d++ = b[i+1] & 31, s = 2;
+        else if (i+1 < n && IS_CLASS(OP_GET_VAR, b[i]) && IS_CLASS(OP_UNARY, b[i+1])) *d++ = OP_GET_UNARY, *d++ = b[i] & 31, *d++ = b[i+1] & 31, s = 2;
+        else MEMCPY(d, b+i, s), d += s;
+    }
+    #undef STEP
+    return UNREF_X(r);
+}
+
+// peak stack use of bytecode: it's branch-free, so one pass over the stack effects. a fused segment counts as
+// run op by op, which covers the one push of running it whole
+__attribute__((noinline))
+static K_int depth(K x){
+    K_char *b = CHR_PTR(x);
+    K_int d = 0, m = 0;
+    for (K_int i = 0, n = HDR_COUNT(x); i < n; i += oplen(b+i)){
+        K_char c = b[i], j = c & 31;
+        switch (c >> 5){
+        case 1: --d; break;
+        case 2: d -= j; break; // f and its j args make one
+        case 3: case 4: ++d; break;
+        case 6: d += IS_PRIMITIVE(j); break;
+        case 7: d += (c == OP_MOVE_VAR || c == OP_GET_UNARY || (c == OP_WIDE && !IS_CLASS(OP_SET_VAR, b[i+1])))
+                   - (c == OP_POP || c == OP_FOLD || IS_INT_OP(c)) + (c == OP_ENLIST ? 1 - b[i+1] : 0);
+        }
+        d = MAX(d, 0), m = MAX(m, d);
+    }
+    return m;
+}
+
 // compile source code to bytecode and vars/consts
 // returns (bytecode; variables; constants; sourcecode)
 K load(K src, K vars){
     K tokens, bytecode, consts = 0;
+    K_char varc = vars ? HDR_COUNT(vars) : 0; // args+locals. anything token() adds is global
     tokens = token(src, &vars, &consts);
     if (!tokens || !balanced(tokens)) goto cleanup;
     bytecode = compile(0, tokens, 0);
     if (!bytecode) goto cleanup;
+    bytecode = peephole(bytecode, &consts, varc);
+    bytecode = supers(fusion(folds(moves(bytecode, varc))));
+    HDR_DEPTH(bytecode) = MIN(depth(bytecode), 255);
     return k4(bytecode, vars, consts, src);
 cleanup:
     unref(vars), unref(consts), unref(src);
@@ -409,33 +707,230 @@ K getGlobal(K_sym var){
     return ref(OBJ_PTR(VALS(GLOBALS))[i]);
 }
 
+// slot to assign a global to. globals are read-only to pool tasks (see par)
+__attribute__((noinline))
+static K *setGlobal(K_sym var){
+    NYI_ERROR(kworker, "global assign in parallel each", );
+    return getSlot(GLOBALS, var);
+}
+
+// take the value of a global, leaving its slot empty until the reassignment that follows (see moves)
+__attribute__((noinline))
+K moveGlobal(K_sym var){
+    NYI_ERROR(kworker, "global assign in parallel each", );
+    K keys = KEYS(GLOBALS);
+    K_int i = findSym(keys, var);
+    VALUE_ERROR(i==HDR_COUNT(keys), "undefined variable: ", var, )
+    K *slot = OBJ_PTR(VALS(GLOBALS)) + i, r = *slot;
+    *slot = 0;
+    return r;
+}
+
+// a global's value, without a ref. 0 if undefined
+static K peekGlobal(K_sym var){
+    K keys = KEYS(GLOBALS);
+    K_int i = findSym(keys, var);
+    return i < HDR_COUNT(keys) ? OBJ_PTR(VALS(GLOBALS))[i] : 0;
+}
+
+// run the fused segment b (see fusion) over FUSE_CHUNK-item slices of its list leaves, copying each slice's result
+// into r. a segment ending in OP_FOLD folds the slices' results instead, stopping early once & | are decided.
+// returns 0 to decline, when the leaves aren't tags and equal-length bool/chr/int lists of FUSE_MIN or more:
+// the vm then runs the segment op by op (and raises any error). leaves are borrowed; moved locals are released after
+static bool fuse(K_char *b, K_int len, K_sym *v, K consts, K_char varc, K *args, K *out){
+    K leaf[len], s[STACK_SIZE], *top, r = 0;
+    K_int l = 0, n = -1, fold = len > 1 && b[len-2] == OP_FOLD ? b[len-1] >> 4 : 0, acc = 0;
+    for (K_int i = 0; i < len; i++){
+        K_char c = b[i], j = c & 31;
+        if (c == OP_FOLD || c == OP_MOVE_VAR) j = b[++i];
+        if (c - OP_CONST >= 64u && c != OP_MOVE_VAR) continue; // ops, some quickened by the vm for a declined run
+        K x = IS_CLASS(OP_CONST, c) ? OBJ_PTR(consts)[j] : j < varc ? args[j] : peekGlobal(v[j]);
+        if (!x || (!IS_TAG(x) && (!IS_VECTOR(x) || HDR_COUNT(x) < FUSE_MIN || (n >= 0 && HDR_COUNT(x) != n)))) return 0;
+        if (!IS_TAG(x)) n = HDR_COUNT(x);
+        leaf[l++] = x;
+    }
+    if (n < 0 && !kworker) b[-2] = OP_UNFUSED; // scalar code: stop paying for the scan (see vm)
+    if (n < FUSE_MIN) return 0;
+    for (K_int lo = 0; lo < n; lo += FUSE_CHUNK){
+        K_int m = MIN(n - lo, (K_int)FUSE_CHUNK);
+        top = s + STACK_SIZE, l = 0;
+        for (K_int i = 0; i < len; i++){
+            K_char c = IS_INT_OP(b[i]) ? OP_BINARY + INT_OP(b[i]) : b[i], j = c & 31;
+            if (IS_CLASS(OP_UNARY, c)) *top = unary_op[j](*top);
+            else if (IS_CLASS(OP_BINARY, c)){ K a = *top++; *top = binary_op[j](a, *top); }
+            else if (c == OP_FOLD){ K a = *top++; *top = cmpOver(fold, b[++i] & 15, a, *top); }
+            else { K x = leaf[l++]; i += c == OP_MOVE_VAR; *--top = IS_TAG(x) ? x : knewcopy(HDR_TYPE(x), m, AT(HDR_TYPE(x), x, lo)); }
+            if (!*top){ while (top < s+STACK_SIZE) unref(*top++); unref(r); return *out = 0, 1; }
+        }
+        if (fold){ // & | slices give bools: stop at the first that decides
+            acc = fold == 1 ? acc + TAG_VAL(*top) : TAG_VAL(*top);
+            if (fold != 1 && acc == (fold == 6)) break;
+            continue;
+        }
+        if (!r) r = knew(HDR_TYPE(*top), n);
+        MEMCPY(AT(HDR_TYPE(r), r, lo), *top, NBYTES(HDR_TYPE(r), m));
+        unref(*top);
+    }
+    if (fold) r = fold == 1 ? kint(acc) : TAG(KBoolType, acc);
+    else if (HDR_TYPE(r) == KBoolType) zeroBoolTail(r);
+    for (K_int i = 0; i < len; i++) if (b[i] == OP_MOVE_VAR && b[++i] < varc) unref(args[b[i]]), args[b[i]] = 0;
+    return *out = r, 1;
+}
+
+// dispatch: with labels-as-values every handler jumps to the next through a 256-entry table indexed by the whole
+// opcode, so each op site gets its own indirect branch to predict instead of all sharing the switch's. VM_SWITCH
+// (or a compiler without the extension) falls back to a switch of gotos. handlers decode their index from ip[-1]
+#if defined(__GNUC__) && !defined(VM_SWITCH)
+#define THREADED
+#define NEXT goto *(ip < e ? op[*ip++] : &&done)
+#else
+#define NEXT goto next
+#endif
+
+// int atoms: a binary op that sees two quickens its opcode to OP_INT+k, a one-entry inline cache. the quickened handler
+// computes in place behind a type guard; a miss restores the generic op and takes it. bytecode is only rewritten
+// outside pool tasks (kworker), so it never changes under another thread (see par)
+#define INT2(a, b) (TAG_TYPE(a) == KIntType && TAG_TYPE(b) == KIntType)
+#define QUICK(l, E) l: a=*top++; if (INT2(a,*top)){ K_int x = TAG_VAL(a), y = TAG_VAL(*top); *top = E; NEXT; } \
+    i=INT_OP(ip[-1]); if (!kworker) ip[-1]=OP_BINARY+i; goto generic;
+
+// a lambda call run inside the vm loop: the caller's state, and the callee, held till it returns. args and base are
+// offsets from the stack's end: the stack grows down, so they survive it moving to a bigger one
+typedef struct { K f; K_char *ip, *e; K_sym *v; K consts; K_char varc; K_int args, base; } Frame;
+// the vm's cold state, apart so the handlers' registers go to ip, top and the code: stack bounds, heap stack
+// once past the C one, frames in use and room, heap frames once past fin. base and args pass through grow
+typedef struct { K *lo, *end, *xargs, hs, *base, *args; Frame *fr; K_int nf, fcap; K fs; Frame fin[16]; } VM;
+
+// value stack room for bytecode x (see depth)
+#define NEED(x) (HDR_DEPTH(x) < 255 ? HDR_DEPTH(x) : depth(x))
+#define ROOM(n) if (top - m.lo < (n)){ m.base = base, m.args = args; top = grow(&m, top, n); base = m.base, args = m.args; }
+
+// make room for n more values below top, returning the new top. the stack starts as a C array and moves to a heap
+// one twice the size
+__attribute__((noinline))
+static K *grow(VM *m, K *top, K_int n){
+    K_int c = 2*(m->end - m->lo) + n, t = m->end - top;
+    K s = knew(KLngType, c);
+    MEMCPY(OBJ_PTR(s) + c - t, top, t * sizeof(K));
+    K *end = OBJ_PTR(s) + c;
+    m->base = end - (m->end - m->base);
+    if (m->nf) m->args = end - (m->end - m->args);
+    unref(m->hs), m->hs = s, m->lo = OBJ_PTR(s), m->end = end;
+    return end - t;
+}
+
 // interpret bytecode
 // NB: does not consume (unref) any args
-// limits:
-// - 32 constants per expression
-// - 32 variables per expression (incl. args/locals/globals)
+// limits: see CONSTS_MAX, VARS_MAX
+// a lambda applied with all its args, by f[..] or f x, runs in this loop on an explicit frame rather than recursing
+// through apply: its locals go on the value stack, and one in tail position replaces the caller's frame instead.
+// so recursion depth is bounded by CALLS_MAX, not the C stack. calls from adverbs still go through apply
 K vm(K x, K vars, K consts, K_char varc, K*args){
+#ifdef THREADED
+    static void *op[256] = {
+        [OP_UNARY ... OP_BINARY-1] = &&unary, [OP_BINARY ... OP_N_ARY-1] = &&binary, [OP_N_ARY ... OP_CONST-1] = &&nary,
+        [OP_CONST ... OP_GET_VAR-1] = &&cnst, [OP_GET_VAR ... OP_SET_VAR-1] = &&get, [OP_SET_VAR ... OP_VERB-1] = &&set,
+        [OP_VERB ... OP_SPECIAL-1] = &&verb, [OP_POP] = &&pop, [OP_ENLIST] = &&enlist, [OP_MOVE_VAR] = &&move,
+        [OP_FUSE] = &&fuse, [OP_FOLD] = &&fold, [OP_CONST_BINARY] = &&cbinary, [OP_GET_UNARY] = &&gunary,
+        [OP_INT] = &&iadd, [OP_INT+1] = &&isub, [OP_INT+2] = &&imul, [OP_INT+3] = &&imin, [OP_INT+4] = &&imax,
+        [OP_INT+5] = &&iltn, [OP_INT+6] = &&imtn, [OP_INT+7] = &&ieql, [OP_UNFUSED] = &&unfused, [OP_WIDE] = &&wide, [OP_WIDE+1 ... 255] = &&nop,
+    };
+#endif
+    static unsigned retry; // see unfused. main thread only
     K_sym *v = SYM_PTR(vars);
-    K_char *ip = CHR_PTR(x), *e = ip + HDR_COUNT(x);
+    K_char *ip = CHR_PTR(x), *e = ip + HDR_COUNT(x), i;
     K stack[STACK_SIZE], *top = stack+STACK_SIZE, *base = top, a; // stack grows down
-    while (ip < e){
-        K_char i = *ip & 31; // index: lower 5 bits
-        switch(*ip++ >> 5){  // class: upper 3 bits
-        case 0: *top=unary_op[i](*top); if(!*top) goto bail; break;
-        case 1: a=*top++; *top=binary_op[i](a,*top); if (!*top) goto bail; break;
-        case 2: K r=apply(a=*top,i,top+1); unref(a); top+=i; *top=r; if (!*top) goto bail; break;
-        case 3: *--top=ref(OBJ_PTR(consts)[i]); break;
-        case 4: *--top=i<varc?ref(args[i]):getGlobal(v[i]); if (!*top) goto bail; break;
-        case 5: K*slot=i<varc?args+i:getSlot(GLOBALS,v[i]); unref(*slot); *slot=ref(*top); break;
-        case 6: if(IS_PRIMITIVE(i))*--top=kop(i); else *top=kadverb(*top,i-ADVERB_START); break;
-        case 7: switch(i){ // special ops 0:pop 1:enlist
-                case 0: if (top!=base) unref(*top++); break; // guard: empty subexprs (';;') emit unmatched POP
-                case 1: K_int n=*ip++; a=knew(KObjType,n); top+=n; MEMCPY(a,top-n,sizeof(K)*n); *--top=squeeze(a); break;
-                }
+    VM m; // not an initializer: that would clear fin on every call
+    m.lo = stack, m.end = top, m.xargs = args, m.hs = m.fs = 0, m.fr = m.fin, m.nf = 0, m.fcap = 16;
+    ROOM(NEED(x));
+    NEXT;
+#ifndef THREADED
+next:
+    if (ip >= e) goto done;
+    switch(*ip++ >> 5){ // class: upper 3 bits
+    case 0: goto unary; case 1: goto binary; case 2: goto nary; case 3: goto cnst;
+    case 4: goto get;   case 5: goto set;    case 6: goto verb;
+    case 7: switch(ip[-1] & 31){ // special ops 0:pop 1:enlist 2:move 3:fuse 4:fold 5:const+binary 6:get+unary
+            case 0: goto pop; case 1: goto enlist; case 2: goto move; case 3: goto fuse; case 4: goto fold;
+            case 5: goto cbinary; case 6: goto gunary; case 7: goto iadd; case 8: goto isub; case 9: goto imul;
+            case 10: goto imin; case 11: goto imax; case 12: goto iltn; case 13: goto imtn; case 14: goto ieql;
+            case 15: goto unfused; case 16: goto wide; }
+    }
+    goto nop;
+#endif
+unary:  i=ip[-1]&31; *top=unary_op[i](*top); if(!*top) goto bail; NEXT;
+binary: i=ip[-1]&31; a=*top++;
+        if (i==10 && !IS_TAG(a) && HDR_TYPE(a)==KLambdaType && HDR_ARGC(a)==1){ --top, i=1; goto call; } // f x
+        if (INT2(a,*top) && i && i != 4 && i < 10 && !kworker) ip[-1]=OP_INT+(i<4?i-1:i-2); // quicken
+generic: *top=binary_op[i](a,*top); if (!*top) goto bail; NEXT;
+nary:   i=ip[-1]&31; a=*top; if (!IS_TAG(a) && HDR_TYPE(a)==KLambdaType && HDR_ARGC(a)==i) goto call;
+        K r=apply(a,i,top+1); unref(a); top+=i; *top=r; if (!*top) goto bail; NEXT;
+cnst:   i=ip[-1]&31; *--top=ref(OBJ_PTR(consts)[i]); NEXT;
+get:    i=ip[-1]&31; *--top=i<varc?(IS_TAG(args[i])?args[i]:ref(args[i])):getGlobal(v[i]); if (!*top) goto bail; NEXT; // atoms need no ref: skip the call
+set:    i=ip[-1]&31; K*slot=i<varc?args+i:setGlobal(v[i]); if (!slot) goto bail; unref(*slot); *slot=ref(*top); NEXT;
+verb:   i=ip[-1]&31; if(IS_PRIMITIVE(i))*--top=kop(i); else *top=kadverb(*top,i-ADVERB_START); NEXT;
+pop:    if (top!=base) unref(*top++); NEXT; // guard: empty subexprs (';;') emit unmatched POP
+enlist: K_int n=*ip++; a=knew(KObjType,n); top+=n; MEMCPY(a,top-n,sizeof(K)*n); *--top=squeeze(a); NEXT;
+move:   i=*ip++; if (i<varc){ *--top=args[i]; args[i]=0; } else if (!(*--top=moveGlobal(v[i]))) goto bail; NEXT;
+fuse:   i=*ip++; if (fuse(ip,i,v,consts,varc,args,&a)){ ip+=i; if (!(*--top=a)) goto bail; } NEXT;
+unfused: ++ip; if (!kworker && !(++retry & (FUSE_RETRY-1))) ip[-2]=OP_FUSE; NEXT; // lists may come back: retry now and then
+fold:   i=*ip++; a=*top++; *top=cmpOver(i>>4,i&15,a,*top); if (!*top) goto bail; NEXT;
+cbinary: i=ip[1]; a=ref(OBJ_PTR(consts)[*ip]); ip+=2; *top=binary_op[i](a,*top); if (!*top) goto bail; NEXT;
+gunary: i=*ip; if (!(a=i<varc?ref(args[i]):getGlobal(v[i]))) goto bail; i=ip[1]; ip+=2; *--top=unary_op[i](a); if (!*top) goto bail; NEXT;
+QUICK(iadd, TAG(KIntType, (uint32_t)x + (uint32_t)y))
+QUICK(isub, TAG(KIntType, (uint32_t)x - (uint32_t)y))
+QUICK(imul, TAG(KIntType, (uint32_t)x * (uint32_t)y))
+QUICK(imin, TAG(KIntType, MIN(x, y)))
+QUICK(imax, TAG(KIntType, MAX(x, y)))
+QUICK(iltn, TAG(KBoolType, x < y))
+QUICK(imtn, TAG(KBoolType, x > y))
+QUICK(ieql, TAG(KBoolType, x == y))
+wide:   K_int w=WIDE_INDEX(ip-1); i=*ip>>5; ip+=2; // class 3 const, 4 get, 5 set
+        if (i==3) *--top=ref(OBJ_PTR(consts)[w]);
+        else if (i==4){ if (!(*--top=w<varc?ref(args[w]):getGlobal(v[w]))) goto bail; }
+        else { K*slot=w<varc?args+w:setGlobal(v[w]); if (!slot) goto bail; unref(*slot); *slot=ref(*top); }
+        NEXT;
+nop:    NEXT;
+call: { // lambda a at *top, its i args above. locals sit right under the caller's stack: args first, the rest 0
+        K_char n=HDR_VARC(a); K *c, t[32], *s=t, r;
+        if (JIT_OF(a) && (r=JIT_FN(a)(top+1))){ unref(a); top+=i; *top=r; NEXT; } // int atoms: no frame needed
+        if (ip==e && m.nf && top+i+1==base){ // tail call: the frame is free once its locals go
+            for (K_int k=0; k<i; k++) t[k]=top[1+k];
+            FOR(varc) unref(args[i]);
+            top=args+varc; ROOM(n+NEED(OBJ_PTR(a)[0])); c=top;
+            unref(m.fr[m.nf-1].f); m.fr[m.nf-1].f=a;
+        } else {
+            if (m.nf==CALLS_MAX){ kerrno=KERR_STACK, kerrstr="lambda calls nested too deep"; goto bail; }
+            if (m.nf==m.fcap){ K f=knew(KChrType,2*m.fcap*sizeof(Frame)); MEMCPY(f,m.fr,m.nf*sizeof(Frame)); unref(m.fs); m.fs=f, m.fr=(Frame*)f, m.fcap*=2; }
+            ROOM(n+NEED(OBJ_PTR(a)[0]));
+            c=top+i+1, s=top+1; // the args slide down into place: copying up from the bottom is safe
+            m.fr[m.nf]=(Frame){a,ip,e,v,consts,varc,m.nf?m.end-args:0,m.end-base}; ++m.nf;
         }
+        args=base=top=c-n;
+        for (K_int k=0; k<n; k++) args[k]=k<i?s[k]:0;
+        x=OBJ_PTR(a)[0], ip=CHR_PTR(x), e=ip+HDR_COUNT(x), v=SYM_PTR(OBJ_PTR(a)[1]), consts=OBJ_PTR(a)[2], varc=n;
+        NEXT;
     }
-    return top == base ? knull() : *top;
-bail: while(top < base) unref(*top++); return 0;
+done:   a = top == base ? knull() : *top;
+        if (m.nf){ // return to the caller's frame
+            FOR(varc) unref(args[i]);
+            Frame *f=m.fr+--m.nf; top=args+varc; unref(f->f);
+            ip=f->ip, e=f->e, v=f->v, consts=f->consts, varc=f->varc, args=m.nf?m.end-f->args:m.xargs, base=m.end-f->base;
+            *--top=a; NEXT;
+        }
+        if (m.hs) unref(m.hs);
+        if (m.fs) unref(m.fs);
+        return a;
+bail:   for (;;){ // unwind every frame
+            while (top < base) unref(*top++);
+            if (!m.nf) break;
+            FOR(varc) unref(args[i]);
+            Frame *f=m.fr+--m.nf; top=args+varc; unref(f->f);
+            varc=f->varc, args=m.nf?m.end-f->args:m.xargs, base=m.end-f->base;
+        }
+        if (m.hs) unref(m.hs);
+        if (m.fs) unref(m.fs);
+        return 0;
 }
 
 void strip(K x){
@@ -486,6 +981,14 @@ K timeExpr(K x){
     return kint((t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000);
 }
 
+// \p [N]
+// pool size for parallel each: sets it if N given, returns it
+K poolSize(K x){
+    PARSE_ERROR(HDR_COUNT(x) > 2 && (HDR_COUNT(x) < 4 || CHR_PTR(x)[2] != ' '), 2, "'\\p N' expected", unref(x));
+    K_int n = HDR_COUNT(x) > 2 ? threads(int4chr(HDR_COUNT(x)-3, CHR_PTR(x)+3)) : nthreads;
+    return UNREF_X(kint(n));
+}
+
 K evalFile(K x){
     K_int i = 2;
     PARSE_ERROR(HDR_COUNT(x)<4 || CHR_PTR(x)[2] != ' ', i, "'\\l file.k' expected", unref(x));
@@ -494,6 +997,59 @@ K evalFile(K x){
     return UNREF_X(kfile(kstr(HDR_COUNT(x)-i, CHR_PTR(x)+i)));
 }
 
+// recently loaded lines, most recent first: (bytecode;vars;consts;src) as load gives them, keyed by src. a repeated
+// line skips token+compile. sym ids in the bytecode outlive nothing but the sym table, so freeSymTab empties this
+static K loads[LOADS_CACHED];
+
+// load x (consumed) through the cache. pool tasks bypass it
+static K cachedLoad(K x){
+    if (kworker) return load(x, 0);
+    K_int n = HDR_COUNT(x), i = 0;
+    while (i < LOADS_CACHED && loads[i] && (HDR_COUNT(OBJ_PTR(loads[i])[3]) != n || memcmp(CHR_PTR(OBJ_PTR(loads[i])[3]), CHR_PTR(x), n))) ++i;
+    K r;
+    if (i < LOADS_CACHED && loads[i]) r = loads[i], unref(x);
+    else {
+        if (!(r = load(x, 0))) return 0;
+        i = LOADS_CACHED - 1;
+        unref(loads[i]);
+    }
+    memmove(loads + 1, loads, i * sizeof(K));
+    return loads[0] = r, ref(r);
+}
+
+// a list const the run handed out (a:1 2 3) is now shared with the cache, so an in-place append to it would copy.
+// the cache takes a copy instead, leaving the value as a fresh load would have. lambdas don't change: they stay
+static void unshare(K consts){
+    if (consts) FOR_EACH(consts){
+        K c = OBJ_PTR(consts)[i];
+        if (!IS_TAG(c) && HDR_TYPE(c) != KLambdaType && HDR_REFC(c))
+            OBJ_PTR(consts)[i] = kcpy(knew(HDR_TYPE(c), HDR_COUNT(c)), c), unref(c);
+    }
+}
+
+void uncacheLoads(void){
+    FOR(LOADS_CACHED) unref(loads[i]), loads[i] = 0;
+}
+
+// \b f.k: compile to f.kb (see kbuild)
+K buildFile(K x){
+    K_int i = 2;
+    PARSE_ERROR(HDR_COUNT(x)<4 || CHR_PTR(x)[2] != ' ', i, "'\\b file.k' expected", unref(x));
+    while (i < HDR_COUNT(x) && CHR_PTR(x)[i] == ' ') ++i;
+    return UNREF_X(kbuild(kstr(HDR_COUNT(x)-i, CHR_PTR(x)+i)));
+}
+
+// \w f.kw: save the workspace (see writeWorkspace)
+K saveFile(K x){
+    K_int i = 2;
+    PARSE_ERROR(HDR_COUNT(x)<4 || CHR_PTR(x)[2] != ' ', i, "'\\w file.kw' expected", unref(x));
+    while (i < HDR_COUNT(x) && CHR_PTR(x)[i] == ' ') ++i;
+    K path = kstr(HDR_COUNT(x)-i, CHR_PTR(x)+i);
+    unref(x);
+    VALUE_ERROR(HDR_COUNT(path) < 4 || memcmp(CHR_PTR(path) + HDR_COUNT(path) - 3, ".kw", 3), "'\\w filepath' expects filepath like 'file.kw'", path, unref(path));
+    return writeWorkspace(path);
+}
+
 // evaluate a K-string
 K eval(K x){
 
@@ -507,20 +1063,29 @@ K eval(K x){
     if (CHR_PTR(x)[0] == '\\')
         switch (CHR_PTR(x)[1]){
         case 'l': return evalFile(x);
+        case 'b': return buildFile(x);
+        case 'w': return saveFile(x);
         case 't': return timeExpr(x);
+        case 'p': return poolSize(x);
         default: exit(0);
         }
 
     // load source for execution on VM
-    K r = load(x, 0);
-    if (!r) return 0;
+    K r = cachedLoad(x);
+    return r ? exec(r) : 0;
+}
 
-    // check bytecode for OP_SET_VAR or OP_POP as final byte. if yes, return null
+// run a load r (consumed) on the vm: a line's value, or null if it ends in an assignment or pop
+K exec(K r){
+    // check bytecode for OP_SET_VAR or OP_POP as final instruction. if yes, return null
     K bytecode = OBJ_PTR(r)[0];
-    K_char lastOp = CHR_PTR(bytecode)[HDR_COUNT(bytecode)-1];
+    K_char lastOp = OP_POP, *b = CHR_PTR(bytecode); // empty: a dropped push
+    for (K_char *p = b; p < b + HDR_COUNT(bytecode); p += oplen(p)) lastOp = *p == OP_WIDE ? p[1] : *p;
     bool returnNull = lastOp == OP_POP || IS_CLASS(OP_SET_VAR, lastOp); // is last op assignment or OP_POP?
     
     // call VM
-    r = UNREF_R(vm(bytecode, OBJ_PTR(r)[1], OBJ_PTR(r)[2], 0, 0));
+    K consts = OBJ_PTR(r)[2], v = vm(bytecode, OBJ_PTR(r)[1], consts, 0, 0);
+    if (HDR_REFC(r)) unshare(consts); // still cached
+    r = UNREF_R(v);
     return r && returnNull ? UNREF_R(knull()) : r; // don't print if last op is assignment
 }
\ No newline at end of file
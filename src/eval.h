@@ -14,10 +14,23 @@ enum {
     OP_SPECIAL = 0xe0, // special op codes
     OP_POP     = OP_SPECIAL + 0,
     OP_ENLIST  = OP_SPECIAL + 1,
+    OP_MOVE_VAR= OP_SPECIAL + 2, // get variable, handing over ownership. operand byte: var index
+    OP_FUSE    = OP_SPECIAL + 3, // start of a fused segment. operand byte: segment length
+    OP_FOLD    = OP_SPECIAL + 4, // compare-reduce op/x cmp y. operand byte: cmp | op<<4
+    OP_CONST_BINARY = OP_SPECIAL + 5, // push const, apply binary. operand bytes: const index, binary index
+    OP_GET_UNARY    = OP_SPECIAL + 6, // get var, apply unary. operand bytes: var index, unary index
+    OP_INT     = OP_SPECIAL + 7, // +0..7: binary + - * & | < > = quickened for int atoms (see vm)
+    OP_UNFUSED = OP_SPECIAL + 15, // OP_FUSE whose leaves were all atoms last time: run op by op (see fuse)
+    OP_WIDE    = OP_SPECIAL + 16, // const/get/set past index 31. operand bytes: class + index>>8, index&255
 };
 
 #define IS_CLASS(class, b) (b-class < 32u)
+#define IS_INT_OP(b) (b-OP_INT < 8u)
+#define INT_OP(b) ((b)-OP_INT < 3 ? (b)-OP_INT+1 : (b)-OP_INT+2) // quickened op -> binary index
+#define WIDE_INDEX(p) (((p)[1] & 31) << 8 | (p)[2]) // index of the OP_WIDE instruction at p
 #define IS_OPERATOR(x) ((x) < 20u)  // raw operators. see OPS
+// lambda body is atomic in its args (see atomic() in eval.c). flag lives on the bytecode's attribute byte
+#define IS_ATOMIC_LAMBDA(f) (!IS_TAG(f) && HDR_TYPE(f) == KLambdaType && HDR_ATTR(OBJ_PTR(f)[0]))
 #define IS_PRIMITIVE(x) ((x) < ADVERB_START) // operator + keywords
 #define ADVERB_START 26u // 26-28: ' / \  +3 gives their ':' forms ': /: \:
 
@@ -27,9 +40,13 @@ extern K KEYWORDS; // unary primitive keywords symlist
 
 K token(K,K*,K*);
 K compile(K, K, int);
+K load(K, K);
 K getGlobal(K_sym);
+K moveGlobal(K_sym);
 K vm(K x, K vars, K consts, K_char localc, K*args);
 void strip(K);
+void uncacheLoads(void);
+K exec(K);
 K eval(K);
 
 #endif
\ No newline at end of file
@@ -1,23 +1,26 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
 #include "file.h"
 #include "object.h"
 #include "error.h"
+#include "image.h"
+#include "eval.h"
 
-// forward declaration (rather than #include to break cycle eval->file->eval)
-K eval(K);
-
-// read a file into a K_char list
+// read a file into a K_char list. from MAP_MIN bytes the list is the file mapped (see kmap), not a copy of it
 K readFile(K path) {
     path = joinTag(path, 0);
-    FILE *f = fopen((char*)CHR_PTR(path), "rb");
-    VALUE_ERROR(!f, "can't open file: ", path, unref(path));
-    
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    
-    K r = knew(KChrType, size);
-    fread(CHR_PTR(r), 1, size, f);
-    fclose(f);
+    int fd = open((char*)CHR_PTR(path), O_RDONLY);
+    VALUE_ERROR(fd < 0, "can't open file: ", path, unref(path));
+    struct stat st;
+    bool bad = fstat(fd, &st) || st.st_size > INT32_MAX;
+    K_int n = bad ? 0 : st.st_size;
+    K r = bad ? 0 : n >= MAP_MIN ? kmap(fd, n) : knew(KChrType, n);
+    if (r && n < MAP_MIN)
+        for (K_int i = 0, k; i < n; i += k) if ((k = read(fd, CHR_PTR(r) + i, n - i)) <= 0) { unref(r), r = 0; break; }
+    close(fd);
+    VALUE_ERROR(!r, "can't read file: ", path, unref(path));
     
     unref(path);
     return r;
@@ -29,16 +32,35 @@ static K readLines(K path){
     return f ? cutStr(f, '\n') : 0;
 }
 
-// execute a .k file
+// does path end in ext
+static bool hasExt(K path, const char *ext){
+    K_int n = HDR_COUNT(path), m = strlen(ext);
+    return n > m && !memcmp(CHR_PTR(path) + n - m, ext, m);
+}
+
+// run an image of a script (see kbuild): loads go straight to the vm, \cmd lines through eval
+static K imageFile(K path){
+    K x = readImage(path), r = 0;
+    if (!x) return 0;
+    TYPE_ERROR(IS_TAG(x) || HDR_TYPE(x) != KObjType, "'\\l file.kb' expects a script image", unref(x));
+    FOR_EACH(x){
+        K l = OBJ_PTR(x)[i];
+        OBJ_PTR(x)[i] = 0; // hand it over: exec keeps its consts unless it is shared
+        unref(r);
+        r = HDR_TYPE(l) == KChrType ? eval(l) : exec(l);
+        if (!r) { unref(x); return 0; };
+    }
+    unref(x);
+    return r;
+}
+
+// execute a .k file, or a .kb image of one. a .kw workspace replaces this one
 K kfile(K path){
     // sanity checks and file read
     TYPE_ERROR(IS_TAG(path) || HDR_TYPE(path) != KChrType, "'\\l filepath' expects KChrType list", unref(path));
-    VALUE_ERROR(
-        HDR_COUNT(path) < 3 || (CHR_PTR(path)[HDR_COUNT(path)-2] != '.' || CHR_PTR(path)[HDR_COUNT(path)-1] != 'k'),
-        "'\\l filepath' expects filepath like 'file.k'",
-        path,
-        unref(path)
-    );
+    if (hasExt(path, ".kb")) return imageFile(path);
+    if (hasExt(path, ".kw")) return readWorkspace(path);
+    VALUE_ERROR(!hasExt(path, ".k"), "'\\l filepath' expects filepath like 'file.k'", path, unref(path));
     K r = 0, line = readLines(path);
     if (!line) return 0;
     // evaluate line one by one
@@ -52,4 +74,25 @@ K kfile(K path){
     }
     unref(line);
     return r;
-}
\ No newline at end of file
+}
+
+// compile f.k to the image f.kb: each line's load, in order, so \l f.kb skips token and compile. \cmd lines are
+// kept as source, to run through eval. a line that doesn't compile fails the build with its error, and so does
+// \l f.kw: the image's sym ids are mapped before it runs, onto the table a workspace would replace
+K kbuild(K path){
+    TYPE_ERROR(IS_TAG(path) || HDR_TYPE(path) != KChrType, "'\\b filepath' expects KChrType list", unref(path));
+    VALUE_ERROR(!hasExt(path, ".k"), "'\\b filepath' expects filepath like 'file.k'", path, unref(path));
+    K out = joinTag(ref(path), 'b'), line = readLines(path), r = knew(KObjType, 0);
+    if (!line) return unref(out), unref(r), 0;
+    FOR_EACH(line){
+        K l = ref(OBJ_PTR(line)[i]);
+        if (HDR_COUNT(l)) strip(l);
+        if (!HDR_COUNT(l)) { unref(l); continue; }
+        VALUE_ERROR(hasExt(l, ".kw") && CHR_PTR(l)[1] == 'l' && CHR_PTR(l)[0] == '\\', "an image can't load a workspace: ", l,
+            (unref(l), unref(out), unref(line), unref(r)));
+        if (CHR_PTR(l)[0] != '\\' && !(l = load(l, 0))) { unref(out), unref(line), unref(r); return 0; }
+        r = joinObj(r, l);
+    }
+    unref(line);
+    return writeImage(out, r);
+}
@@ -5,5 +5,6 @@
 
 K readFile(K);
 K kfile(K);
+K kbuild(K);
 
-#endif
\ No newline at end of file
+#endif
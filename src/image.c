@@ -0,0 +1,154 @@
+// images: a K value written to a file, and read back from one mmap. a script image starts with the sym pool's
+// names, so the sym ids in it (sym atoms and lists, lambda vars) map onto this process's on read; everything else is
+// copied as it lies. a workspace carries the sym table itself instead, so its ids stay as they are. lambdas get
+// their native code back (see jit). native byte order and K layout: an image is for the build that wrote it, and is
+// trusted like a script: bytecode in it runs as is. an object referenced twice is written, and read back, twice
+//
+// script:    "krb1" | u32 syms | per sym: u32 length, chars | value
+// workspace: "krw1" | value (SYMS;HTAB;GLOBALS)
+// value:     u8 255, u64 K (tags and 0) | u8 type, u8 a, u8 m, u32 count, then items: values if nested, else raw bytes
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "image.h"
+#include "object.h"
+#include "sym.h"
+#include "error.h"
+#include "jit.h"
+#include "eval.h"
+
+#define MAGIC "krb1"
+#define MAGIC_WS "krw1"
+
+static void put(FILE *f, K x){
+    if (!x || IS_TAG(x)){ fputc(255, f); fwrite(&x, 8, 1, f); return; }
+    fputc(HDR_TYPE(x), f), fputc(K_HDR(x).a, f), fputc(K_HDR(x).m, f), fwrite(&HDR_COUNT(x), 4, 1, f);
+    if (IS_NESTED(x)) FOR_EACH(x) put(f, OBJ_PTR(x)[i]);
+    else fwrite((void*)x, 1, XBYTES(x), f);
+}
+
+// write x (consumed) to file path (consumed): a script image, or with ws a workspace (x is then the sym table's)
+static K store(K path, K x, bool ws){
+    path = joinTag(path, 0);
+    FILE *f = fopen((char*)CHR_PTR(path), "wb");
+    VALUE_ERROR(!f, "can't open file: ", path, (unref(path), unref(x)));
+    uint32_t n = HDR_COUNT(SYMS);
+    fwrite(ws ? MAGIC_WS : MAGIC, 1, 4, f);
+    if (!ws){
+        fwrite(&n, 4, 1, f);
+        FOR(n){
+            K s = OBJ_PTR(SYMS)[i];
+            fwrite(&HDR_COUNT(s), 4, 1, f), fwrite((void*)s, 1, HDR_COUNT(s), f);
+        }
+    }
+    put(f, x);
+    bool bad = ferror(f);
+    bad |= fclose(f) != 0;
+    VALUE_ERROR(bad, "can't write file: ", path, (unref(path), unref(x)));
+    unref(path), unref(x);
+    return knull();
+}
+
+typedef struct { K_char *p, *e; K_sym *map; uint32_t syms; bool bad; } In;
+
+static bool take(In *in, void *d, K_int n){
+    if (in->bad || in->e - in->p < n) return in->bad = 1, 0;
+    memcpy(d, in->p, n), in->p += n;
+    return 1;
+}
+
+static K_sym sym(In *in, K_sym i){
+    if (!in->map) return i; // workspace
+    if (i < in->syms) return in->map[i];
+    return in->bad = 1, 0;
+}
+
+// the value at in->p. a bad image reads as 0s from where it went wrong, so whatever was built can still be released
+static K get(In *in){
+    K_char t, a, m;
+    uint32_t n;
+    if (!take(in, &t, 1)) return 0;
+    if (t == 255){
+        K x = 0;
+        take(in, &x, 8);
+        return TAG_TYPE(x) == KSymType ? TAG(KSymType, sym(in, TAG_VAL(x))) : x;
+    }
+    if (!take(in, &a, 1) || !take(in, &m, 1) || !take(in, &n, 4) || t > KAdverbType) return in->bad = 1, 0;
+    bool nested = !t || t >= K_GENERIC_TYPES_START;
+    if ((nested ? (K_int)n * 7 : NBYTES(t, (K_int)n)) > in->e - in->p) return in->bad = 1, 0;
+    K x = knew(nested ? KObjType : t, n + (t == KLambdaType)); // a lambda's native code sits past its count
+    HDR_TYPE(x) = t, HDR_COUNT(x) = n, K_HDR(x).a = a, K_HDR(x).m = m;
+    if (nested) FOR(n) OBJ_PTR(x)[i] = get(in);
+    else {
+        take(in, (void*)x, NBYTES(t, (K_int)n));
+        if (t == KSymType) FOR(n) SYM_PTR(x)[i] = sym(in, SYM_PTR(x)[i]);
+    }
+    if (t == KLambdaType){
+        K *f = OBJ_PTR(x);
+        JIT_OF(x) = 0;
+        if (n != 4 || IS_TAG(f[0]) || HDR_TYPE(f[0]) != KChrType || IS_TAG(f[1]) || HDR_TYPE(f[1]) != KSymType
+            || (f[2] && (IS_TAG(f[2]) || HDR_TYPE(f[2]) != KObjType))) in->bad = 1;
+        else JIT_OF(x) = jit(x);
+    }
+    return x;
+}
+
+// the value in image file path (consumed): a script image, or with ws a workspace
+static K fetch(K path, bool ws){
+    path = joinTag(path, 0);
+    int fd = open((char*)CHR_PTR(path), O_RDONLY);
+    VALUE_ERROR(fd < 0, "can't open file: ", path, unref(path));
+    struct stat st;
+    K_char *p = fstat(fd, &st) || !st.st_size ? MAP_FAILED : mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    VALUE_ERROR(p == MAP_FAILED, "can't read file: ", path, unref(path));
+    In in = {p, p + st.st_size, 0, 0, 0};
+    K map = 0, x = 0;
+    if (st.st_size < 8 || memcmp(p, ws ? MAGIC_WS : MAGIC, 4)) in.bad = 1;
+    else if (ws) in.p += 4, x = get(&in);
+    else {
+        in.p += 4, take(&in, &in.syms, 4);
+        if ((K_int)in.syms * 4 > in.e - in.p) in.bad = 1;
+        map = knew(KSymType, in.bad ? 0 : in.syms);
+        in.map = SYM_PTR(map);
+        FOR(HDR_COUNT(map)){
+            uint32_t l = 0;
+            if (!take(&in, &l, 4) || in.e - in.p < l){ in.bad = 1; break; }
+            in.map[i] = internSym(l, in.p), in.p += l;
+        }
+        x = get(&in);
+    }
+    munmap(p, st.st_size);
+    unref(map);
+    VALUE_ERROR(in.bad || in.p != in.e, "bad image: ", path, (unref(path), unref(x)));
+    unref(path);
+    return x;
+}
+
+K writeImage(K path, K x){ return store(path, x, 0); }
+K readImage(K path){ return fetch(path, 0); }
+
+// \w f.kw: GLOBALS, with the sym table that names its syms
+K writeWorkspace(K path){
+    return store(path, k3(ref(SYMS), ref(HTAB), ref(GLOBALS)), 1);
+}
+
+// \l f.kw: the workspace in f.kw replaces this one, sym table and all. ids and HTAB's chains come back as they were
+// written, so nothing is rehashed; only KEYWORDS, which names syms, is made again. cached loads go with the old table
+K readWorkspace(K path){
+    K x = fetch(path, 1);
+    if (!x) return 0;
+    K *w = OBJ_PTR(x);
+    #define IS_OBJ(y) (!IS_TAG(y) && HDR_TYPE(y) == KObjType)
+    TYPE_ERROR(!IS_OBJ(x) || HDR_COUNT(x) != 3 || !IS_OBJ(w[0]) || !IS_OBJ(w[1]) || !HDR_COUNT(w[1]) || !IS_OBJ(w[2])
+        || HDR_COUNT(w[2]) != 2 || IS_TAG(KEYS(w[2])) || HDR_TYPE(KEYS(w[2])) != KSymType, "not a workspace", unref(x));
+    #undef IS_OBJ
+    freeSymTab(), unref(GLOBALS), unref(KEYWORDS);
+    SYMS = ref(w[0]), HTAB = ref(w[1]), GLOBALS = ref(w[2]);
+    unref(x);
+    KEYWORDS = syms4chrs(cutStr(kcstr(KEYWORDS_STRING), ' '));
+    return knull();
+}
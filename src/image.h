@@ -0,0 +1,11 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include "krua.h"
+
+K writeImage(K, K);
+K readImage(K);
+K writeWorkspace(K);
+K readWorkspace(K);
+
+#endif
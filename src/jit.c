@@ -0,0 +1,148 @@
+// native code for scalar lambdas: bodies of args, int consts and + - * & | < > = neg, with no locals, become
+// straight-line x86-64. the bytecode's stack maps onto 8 registers and every op computes in 32 bits, wrapping like
+// the vm's quickened ones (see QUICK). a guard up front returns 0 unless each arg is an int atom, and the caller
+// runs the bytecode instead: so the code never allocates, refs or raises. it is written once, when the lambda is
+// made, into one mmap'd arena kept for the process; identical code is shared, so redefining a lambda costs nothing.
+// other targets, or NO_JIT, build without it
+
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS
+
+#include "jit.h"
+#include "eval.h"
+
+K_char *jitArena;
+
+#ifdef JIT
+
+#include <sys/mman.h>
+
+static K_int used; // arena bytes taken: each entry is its length (4 bytes) then its code
+
+static const K_char REG[8] = {1, 2, 6, 8, 9, 10, 11, 0}; // stack slot -> register: ecx edx esi r8d-r11d eax. rdi: args
+
+typedef struct { K_char c[JIT_CODE]; K_int n, sp; K_char t[8]; } Jit; // code, stack depth, each slot's type
+
+#define B(x) (j->c[j->n++] = (x))
+
+// op reg, rm on registers, with the rex prefix r8-r11 need. byte ops always take one, for sil
+static void rr(Jit *j, bool byte, K_int op, K_char reg, K_char rm){
+    K_char rex = (reg >> 3) << 2 | rm >> 3;
+    if (rex || byte) B(0x40 | rex);
+    if (op > 255) B(op >> 8);
+    B(op), B(0xc0 | (reg & 7) << 3 | (rm & 7));
+}
+
+static bool push(Jit *j, K_char t){
+    if (j->sp == 8 || j->n > JIT_CODE - 64) return 0;
+    j->t[j->sp++] = t;
+    return 1;
+}
+
+// mov r32, imm32
+static bool pushConst(Jit *j, K x){
+    if (TAG_TYPE(x) != KIntType || !push(j, KIntType)) return 0;
+    K_char r = REG[j->sp-1];
+    if (r > 7) B(0x41);
+    B(0xb8 + (r & 7));
+    FOR(4) B((K_char)(x >> 8*i));
+    return 1;
+}
+
+// mov r32, [rdi+8*i]: the low half of a tag is its value
+static bool pushArg(Jit *j, K_int i, K_int argc){
+    if (i >= argc || !push(j, KIntType)) return 0;
+    K_char r = REG[j->sp-1];
+    if (r > 7) B(0x44);
+    B(0x8b), B(0x47 | (r & 7) << 3), B(8*i);
+    return 1;
+}
+
+// left operand on top, right under it, result in the right's slot. i: binary index (see binary_op)
+static bool binary(Jit *j, K_char i){
+    if (j->sp < 2 || j->t[j->sp-1] != KIntType || j->t[j->sp-2] != KIntType || j->n > JIT_CODE - 64) return 0;
+    K_char l = REG[--j->sp], d = REG[j->sp-1];
+    switch (i){
+    case 1: rr(j, 0, 0x01, l, d); break;                               // add d,l
+    case 2: rr(j, 0, 0x29, d, l), rr(j, 0, 0x89, l, d); break;         // sub l,d; mov d,l
+    case 3: rr(j, 0, 0x0faf, d, l); break;                             // imul d,l
+    case 5: case 6: rr(j, 0, 0x39, l, d), rr(j, 0, i == 5 ? 0x0f4f : 0x0f4c, d, l); break; // cmp d,l; cmovg/cmovl d,l
+    case 7: case 8: case 9:                                            // cmp l,d; setl/setg/sete d8; movzx d,d8
+        rr(j, 0, 0x39, d, l), rr(j, 1, i == 7 ? 0x0f9c : i == 8 ? 0x0f9f : 0x0f94, 0, d), rr(j, 1, 0x0fb6, d, d);
+        j->t[j->sp-1] = KBoolType;
+        break;
+    default: return 0;
+    }
+    return 1;
+}
+
+static bool unary(Jit *j, K_char i){
+    if (i != 2 || !j->sp || j->t[j->sp-1] != KIntType || j->n > JIT_CODE - 64) return 0;
+    rr(j, 0, 0xf7, 3, REG[j->sp-1]); // neg
+    return 1;
+}
+
+// compile lambda f: its native code as an int tag of the entry's arena offset (see JIT_FN), or 0 to keep to the vm
+K jit(K f){
+    static bool failed;
+    K x = OBJ_PTR(f)[0], consts = OBJ_PTR(f)[2];
+    K_int argc = HDR_ARGC(f), len = HDR_COUNT(x);
+    K_char *b = CHR_PTR(x);
+    if (failed || HDR_VARC(f) != argc || argc > 15 || !len) return 0;
+    Jit s, *j = &s;
+    j->n = j->sp = 0;
+    B(0x31), B(0xc0), B(0xc3); // offset 0, the guards' target: xor eax,eax; ret
+    for (K_int i = 0; i < argc; i++){ // cmp byte [rdi+8*i+7], KIntType; jne 0
+        B(0x80), B(0x7f), B(8*i+7), B(KIntType), B(0x0f), B(0x85);
+        K_int rel = -(j->n + 4);
+        FOR(4) B((K_char)(rel >> 8*i));
+    }
+    for (K_int i = 0; i < len; i++){
+        K_char c = IS_INT_OP(b[i]) ? OP_BINARY + INT_OP(b[i]) : b[i], k = c & 31;
+        bool ok;
+        switch (c >> 5){
+        case 0: ok = unary(j, k); break;
+        case 1: ok = binary(j, k); break;
+        case 3: ok = pushConst(j, OBJ_PTR(consts)[k]); break;
+        case 4: ok = pushArg(j, k, argc); break;
+        case 7: switch (k){
+                case 0: ok = j->sp > 0, --j->sp; break;                    // pop
+                case 2: ok = i+1 < len && pushArg(j, b[i+1], argc), ++i; break; // move: an atom's is a get
+                case 3: case 15: ok = 1, ++i; break;                       // fuse header: atoms never fuse
+                case 5: ok = i+2 < len && pushConst(j, OBJ_PTR(consts)[b[i+1]]) && binary(j, b[i+2]), i += 2; break;
+                case 6: ok = i+2 < len && pushArg(j, b[i+1], argc) && unary(j, b[i+2]), i += 2; break;
+                default: ok = 0;
+                }
+                break;
+        default: ok = 0;
+        }
+        if (!ok) return 0;
+    }
+    if (!j->sp) return 0;
+    K_char r = REG[j->sp-1];
+    if (r) rr(j, 0, 0x89, r, 0);                            // mov eax,r
+    B(0x48), B(0xb9);                                       // mov rcx, type<<56
+    FOR(8) B((K_char)(((K)j->t[j->sp-1] << 56) >> 8*i));
+    B(0x48), B(0x09), B(0xc8), B(0xc3);                     // or rax,rcx; ret
+
+    if (!jitArena){
+        void *p = mmap(0, JIT_ARENA, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) return failed = 1, 0;
+        jitArena = p;
+    }
+    for (K_int o = 0; o < used; o += 4 + *(uint32_t*)(jitArena + o)) // share identical code
+        if (*(uint32_t*)(jitArena + o) == j->n && !memcmp(jitArena + o + 4, j->c, j->n)) return TAG(KIntType, o + 4 + 3);
+    if (used + 4 + j->n > JIT_ARENA) return 0;
+    if (mprotect(jitArena, JIT_ARENA, PROT_READ | PROT_WRITE)) return failed = 1, 0;
+    *(uint32_t*)(jitArena + used) = j->n;
+    memcpy(jitArena + used + 4, j->c, j->n);
+    K r0 = TAG(KIntType, used + 4 + 3);
+    used += 4 + j->n;
+    if (mprotect(jitArena, JIT_ARENA, PROT_READ | PROT_EXEC)) return failed = 1, 0;
+    return r0;
+}
+
+#else
+
+K jit(K f){ (void)f; return 0; }
+
+#endif
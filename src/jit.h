@@ -0,0 +1,20 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "krua.h"
+
+#if defined(__x86_64__) && !defined(NO_JIT)
+#define JIT // else jit declines every lambda
+#endif
+
+typedef K (*JitFn)(K*); // args in, result out. 0: an arg wasn't an int atom, run the bytecode instead
+
+extern K_char *jitArena;
+
+// native code of lambda f, 0 if it has none (see jit). a tag in a slot past the count: nothing walks or frees it
+#define JIT_OF(f)   OBJ_PTR(f)[4]
+#define JIT_FN(f)   ((JitFn)(jitArena + TAG_VAL(JIT_OF(f))))
+
+K jit(K);
+
+#endif
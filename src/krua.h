@@ -76,7 +76,9 @@ typedef struct {
 #define K_HDR(x)      ((K_hdr*)(x))[-1]
 #define HDR_ARGC(x)   K_HDR(x).a
 #define HDR_ADVERB(x) K_HDR(x).a
+#define HDR_ATTR(x)   K_HDR(x).a
 #define HDR_VARC(x)   K_HDR(x).m
+#define HDR_DEPTH(x)  K_HDR(x).m  // bytecode: peak stack use, 255 for 255 or more
 #define HDR_BUCKET(x) K_HDR(x).b
 #define HDR_TYPE(x)   K_HDR(x).t
 #define HDR_REFC(x)   K_HDR(x).r
@@ -106,6 +108,7 @@ typedef struct {
 #define XBYTES(x)       ({K_int _t=HDR_TYPE(x), _n=HDR_COUNT(x); NBYTES(_t, _n);})
 #define PTR_TO(x, i)    ({ K _x=(x); _x + (i)*WIDTH_OF(_x); })
 #define IS_ATOM(x)      ({ K _x=(x); IS_TAG(_x)||HDR_TYPE(_x)>=K_ATOMIC_GENERICS_TYPE_START ;}) // can we group type enums so atomics are contiguous?
+#define IS_VECTOR(x)    ({ K_char _t=HDR_TYPE(x); _t==KBoolType || _t==KChrType || _t==KIntType ;}) // lists the vector kernels cover
 #define IS_NESTED(x)    ({ K_char _t=HDR_TYPE(x); !_t || _t>=K_GENERIC_TYPES_START ;})
 #define OOB(i, n)       ((uint32_t)(i) >= (uint32_t)(n))
 #define MIN(x, y)       ({ typeof(x)_x=(x); typeof(y)_y=(y); _x<_y?_x:_y; })
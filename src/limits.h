@@ -2,11 +2,29 @@
 #define LIMITS_H
 
 // token/vm
-#define CONSTS_MAX 32  // current bytecode limititation
-#define VARS_MAX 32  // current bytecode limititation
-#define STACK_SIZE 64  // arbitrary. should be suitable for now.
+#define CONSTS_MAX 8192  // per load. 0-31 fit the opcode, the rest take OP_WIDE's 13-bit index
+#define VARS_MAX 8192  // per load (incl. args/locals/globals), as CONSTS_MAX
+#define FOLD_MAX 256  // bytes of the largest list a constant fold keeps (see peephole)
+#define LOCALS_MAX 255  // args+locals per lambda: the vm's varc is a byte
+#define STACK_SIZE 64  // vm value stack on the C stack. a deeper one (or nested lambda calls) moves to the heap
+#define CALLS_MAX (1 << 20)  // lambda calls nested in one vm loop (see vm)
+#define FUSE_CHUNK 2048  // items per slice in a fused segment: a few temporaries of this stay in L1. multiple of 64
+#define FUSE_MIN 4096  // shorter lists run fused segments op by op
+#define FUSE_RETRY 64  // a segment that declined on atoms is retried once per this many runs. power of 2
+#define LOADS_CACHED 64  // repeated source lines eval keeps compiled (see cachedLoad)
+#define JIT_ARENA (1 << 16)  // bytes of native code for all jitted lambdas, kept for the process (see jit)
+#define JIT_CODE 1024  // longest native code of one lambda
+
+// threads
+#define THREADS_MAX 64  // worker pool cap, incl. the main thread
+#define PAR_CHUNK (1 << 15)  // items per pool task in list kernels: cache-sized, a multiple of 512 (vector widths, bool words)
+#define PAR_MIN (1 << 20)  // default list length from which kernels go to the pool
+
+// files
+#define MAP_MIN (1 << 16)  // files from this size are read by mapping them (see kmap), smaller ones copied
 
 // repl
-#define LINE_LEN 256
+#define LINE_LEN 256  // first size of the input line buffer, which grows to fit
+#define OUT_BUF (1 << 16)  // kprint's output buffer (see kwrite)
 
 #endif
\ No newline at end of file
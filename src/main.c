@@ -1,30 +1,76 @@
+#include <unistd.h>
+
 #include "krua.h"
 #include "eval.h"
 #include "object.h"
 #include "sym.h"
 #include "error.h"
+#include "file.h"
+
+static char *buf; // the line being read. grows to the longest line seen
+static size_t cap;
 
-int main(){
-    printf("krua. mit license. "__DATE__".\n\n");
-    
+// read a line of f into buf, without its newline: its length, or -1 at eof
+static K_int readLine(FILE *f){
+    if (!buf && !(buf = malloc(cap = LINE_LEN))) exit(1);
+    size_t n = 0;
+    while (fgets(buf + n, cap - n, f)){
+        n += strlen(buf + n);
+        if (buf[n-1] == '\n') { buf[--n] = 0; return n; }
+        if (n + 1 < cap) return n; // eof without a newline
+        if (!(buf = realloc(buf, cap *= 2))) exit(1);
+    }
+    return n ? (K_int)n : -1;
+}
+
+// eval each line of f, printing the values asked for: a line that ends in an assignment or ; prints nothing (see
+// exec). prompt: the interactive repl, which carries on past errors. else the first error stops it, with status 1
+static int run(FILE *f, bool prompt){
+    while (1){
+        if (prompt) kwrite("  ", 2), kflush();
+        K_int n = readLine(f);
+        if (n < 0) return 0;
+        K r = eval(kstr(n, (K_char*)buf));
+        if (r) kprint(r);
+        else { kperror(buf); if (!prompt) return 1; }
+    }
+}
+
+// krua [-l f] [-e expr | f.k ...]: -l loads f first. -e and scripts run in batch, and exit. else lines come from stdin:
+// the repl on a terminal, in batch when piped
+int main(int argc, char **argv){
     initSymTab();
     GLOBALS = ksymdict();
     KEYWORDS = syms4chrs(cutStr(kcstr(KEYWORDS_STRING), ' '));
 
-    // repl
-    char buf[LINE_LEN];
-    while (1){
-        // print prompt, read input
-        printf("  ");
-        char *f = fgets(buf, LINE_LEN, stdin);
-        if (!f) exit(0);
-
-        // overwrite potential trailing newline
-        char *nl = strchr(buf, '\n');
-        if (nl) *nl = 0;
+    bool script = 0; // any arg but -l f runs in batch, instead of stdin
+    for (int i = 1; i < argc; i++) if (strcmp(argv[i], "-l") || ++i == argc) script = 1;
+    bool repl = !script && isatty(0);
+    char *banner = "krua. mit license. "__DATE__".\n\n";
+    if (repl) kwrite(banner, strlen(banner));
+    atexit(kflush);
 
-        // eval + print 
-        K r = eval(kcstr(buf));
-        r ? kprint(r) : kperror(buf);
+    for (int i = 1; i < argc; i++){
+        char *a = argv[i];
+        size_t n = strlen(a);
+        K r;
+        if (!strcmp(a, "-l") && i + 1 < argc){ // f.k .kb or a .kw workspace
+            if (!(r = kfile(kcstr(a = argv[++i])))) { kperror(a); return 1; }
+            unref(r);
+            continue;
+        }
+        if (!strcmp(a, "-e") && i + 1 < argc) r = eval(kcstr(a = argv[++i]));
+        else if (n > 2 && !strcmp(a + n - 2, ".k")){ // line by line, printing as it goes
+            FILE *f = fopen(a, "r");
+            if (!f) { kflush(), fprintf(stderr, "can't open file: %s\n", a); return 1; }
+            int e = run(f, 0);
+            fclose(f);
+            if (e) return e;
+            continue;
+        }
+        else r = kfile(kcstr(a)); // .kb .kw
+        if (!r) { kperror(a); return 1; }
+        kprint(r);
     }
-}
\ No newline at end of file
+    return script ? 0 : run(stdin, repl);
+}
@@ -1,41 +1,76 @@
 // K object create/destroy/print
 
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS
+
 #include "object.h"
 #include "error.h"
 #include "op_binary.h"
 #include "utils.h"
 #include "sym.h"
+#include "thread.h"
 #include <immintrin.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #define BUCKET_SHIFT 7  // log2(MIN_ALLOC)
 #define NUM_BUCKETS 23
 #define HEAP_SIZE   (1ULL << 29) // 512MiB
-K M[NUM_BUCKETS];   // list of linked lists which are free to use
+static size_t page; // set by the first kmap
+_Thread_local K M[NUM_BUCKETS]; // list of linked lists which are free to use. per thread: each worker has its own arena
 
 // ** K object reference ** //
 
 
-// increment refcount
+// increment refcount. pool tasks share objects (lambdas, consts, globals), so they count atomically
 K ref(K x){
-    if (!IS_TAG(x)) HDR_REFC(x)++;
+    if (!IS_TAG(x)) kworker ? __atomic_fetch_add(&HDR_REFC(x), 1, __ATOMIC_RELAXED) : HDR_REFC(x)++;
     return x;
 }
 
 // decrement refcount
 // internal function, hidden behind `unref`, which may wrap refcount tracking if enabled
 void _unref(K x){
-    if (!x || IS_TAG(x) || HDR_REFC(x)--){
+    if (!x || IS_TAG(x) || (kworker ? __atomic_fetch_sub(&HDR_REFC(x), 1, __ATOMIC_ACQ_REL) : HDR_REFC(x)--)){
         return;
     }
     if (IS_NESTED(x)){
         FOR_EACH(x){ unref(OBJ_PTR(x)[i]); }
     }
+    if (HDR_BUCKET(x) == MAPPED){
+        K_char *p = CHR_PTR(x) - page;
+        munmap(p, *(size_t*)p);
+        return;
+    }
     OBJ_PTR(x)[0] = M[HDR_BUCKET(x)];
     M[HDR_BUCKET(x)] = x;
 }
 
 // ** K object allocate and memcpy ** //
 
+// a chr list of the n bytes of file fd, without reading them: the file is mapped private, so its pages load as they
+// are touched and one that is written becomes this process's own copy. the header ends a page ahead of the data, which
+// starts with the mapping's length, and a page of zeros after the data takes overreads. the list never grows in place
+// (see BUCKET_SIZEOF): an append copies it. 0 if the mapping fails
+K kmap(int fd, K_int n){
+    if (!page) page = sysconf(_SC_PAGESIZE);
+    size_t len = page + (n + page - 1) / page * page + page;
+    K_char *p = mmap(0, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return 0;
+    if (mmap(p + page, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED){
+        munmap(p, len);
+        return 0;
+    }
+    *(size_t*)p = len;
+    K x = (K)(p + page);
+    HDR_ARGC(x) = 0;
+    HDR_BUCKET(x) = MAPPED;
+    HDR_TYPE(x) = KChrType;
+    HDR_REFC(x) = 0;
+    HDR_COUNT(x) = n;
+    return x;
+}
+
 // list creation
 
 // buddy alloc an object
@@ -160,7 +195,7 @@ K syms4chrs(K x){
     return UNREF_X(r);
 }
 
-K_char addSym(K *syms, K_sym x){
+K_int addSym(K *syms, K_sym x){
     // first var name encountered
     if (*syms == 0){
         *syms = knewcopy(KSymType, 1, (K)&x);
@@ -221,6 +256,7 @@ K kcpy(K x, K y){
 // increase the count of list x by n items
 // will reuse x without copy if recount=0 and there is space in the tail
 // otherwise allocates a larger container and copies x
+// NB: buckets are powers of 2, so the copy at least doubles capacity: repeated appends (a,:y) are amortized O(1)
 static K kextend(K x, K_int n){
     n += HDR_COUNT(x);
     K_int bytes = NBYTES(HDR_TYPE(x), n);
@@ -371,9 +407,67 @@ K promote(int t, K x){
 
 // ** K object print ** //
 
+// ** buffered output ** //
+
+// values are formatted straight into one buffer, which goes to fd 1 when full: no stdio call per item. a block as
+// large as the buffer is written as is. anything else writing to stdout calls kflush first
+static K_char obuf[OUT_BUF];
+static K_int on;
+
+static void writeAll(const K_char *s, size_t n){
+    while (n){
+        ssize_t w = write(1, s, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0) return; // a closed pipe: drop the output
+        s += w, n -= w;
+    }
+}
+
+void kflush(void){
+    writeAll(obuf, on);
+    on = 0;
+}
+
+void kwrite(const void *s, size_t n){
+    if (on + n > OUT_BUF) kflush();
+    if (n >= OUT_BUF) writeAll(s, n);
+    else memcpy(obuf + on, s, n), on += n;
+}
+
+// at least n free bytes at the buffer's end
+static inline K_char *room(K_int n){
+    if (on + n > OUT_BUF) kflush();
+    return obuf + on;
+}
+
+static inline void kputc(K_char c){ *room(1) = c, on++; }
+
+static void kputs(const char *s){ kwrite(s, strlen(s)); }
+
+static const char DIGITS2[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// write i in decimal at p, sized first (see intLen), then two digits per step from the right: the end of it
+K_char *fmtInt(K_char *p, K_long i){
+    K_char *e = p + intLen(i);
+    uint64_t u = i < 0 ? (*p = '-', -(uint64_t)i) : (uint64_t)i;
+    K_char *q = e;
+    for (; u >= 100; u /= 100) q -= 2, memcpy(q, DIGITS2 + u % 100 * 2, 2);
+    if (u >= 10) memcpy(q - 2, DIGITS2 + u * 2, 2);
+    else q[-1] = '0' + u;
+    return e;
+}
+
+static inline void putInt(K_long i){ on = fmtInt(room(20), i) - obuf; }
+
+static inline void putSym(K_sym i){
+    K s = OBJ_PTR(SYMS)[i];
+    kputc('`'), kwrite((void*)s, HDR_COUNT(s));
+}
+
+// ** K object print ** //
+
 // recursively print a K object x
 // internal function, hidden behind `kprint`
-// TODO: replace with custom buffered write which can be leveraged by $ (string) and other primitives
 static void _kprint(K x){
     if (!x) return;
     K_char type;
@@ -381,18 +475,17 @@ static void _kprint(K x){
     if (IS_TAG(x)){
         type = TAG_TYPE(x);
         if (type == KBoolType){
-            putchar('0' + TAG_VAL(x));
-            putchar('b');
+            kputc('0' + TAG_VAL(x));
+            kputc('b');
         } else if (type == KChrType){
-            printf("\"%c\"", TAG_VAL(x));
+            kputc('"'), kputc(TAG_VAL(x)), kputc('"');
         } else if (type == KIntType){
-            printf("%d", TAG_VAL(x));
+            putInt((K_int)TAG_VAL(x));
         } else if (type == KSymType){
-            K s = OBJ_PTR(SYMS)[TAG_VAL(x)];
-            printf("`%.*s", HDR_COUNT(s), CHR_PTR(s));
+            putSym(TAG_VAL(x));
         } else if (type == KOpType){
             if (TAG_VAL(x) == 0) return;
-            putchar(OPS[TAG_VAL(x)]);
+            kputc(OPS[TAG_VAL(x)]);
         }
         return;
     }
@@ -401,44 +494,42 @@ static void _kprint(K x){
 
     if (n == 0){
         char *empty[] = {"()", "0#0b", "\"\"", "0#0", "0#0", "0#`"};
-        printf("%s", empty[HDR_TYPE(x)]);
+        kputs(empty[HDR_TYPE(x)]);
         return;
     }
     
-    if (n == 1 && !IS_ATOM(x)) putchar(',');
+    if (n == 1 && !IS_ATOM(x)) kputc(',');
 
     type = HDR_TYPE(x);
     if (type == KObjType){
-        if (n != 1) putchar('(');
+        if (n != 1) kputc('(');
         FOR_EACH(x){ 
-            if (i > 0) putchar(';');
+            if (i > 0) kputc(';');
             _kprint(OBJ_PTR(x)[i]);
         }
-        if (n != 1) putchar(')');
+        if (n != 1) kputc(')');
     } else if (type == KBoolType){
-        FOR_EACH(x) putchar('0' + GET_BIT(x, i));
-        putchar('b');
+        FOR_EACH(x) kputc('0' + GET_BIT(x, i));
+        kputc('b');
     } else if (type == KChrType){
-        printf("\"%.*s\"", n, (K_char*)x);
+        kputc('"'), kwrite((void*)x, n), kputc('"');
     } else if (type == KIntType) {
-        FOR_EACH(x) { printf("%d ", INT_PTR(x)[i]); }
+        FOR_EACH(x) putInt(INT_PTR(x)[i]), obuf[on++] = ' '; // room(20): a K_int takes 11 at most
     } else if (type == KSymType){
-        FOR_EACH(x){
-            K s = OBJ_PTR(SYMS)[SYM_PTR(x)[i]];
-            printf("`%.*s", HDR_COUNT(s), CHR_PTR(s));
-        }
+        FOR_EACH(x) putSym(SYM_PTR(x)[i]);
     } else if (type == KLambdaType) {
         _kprint(OBJ_PTR(x)[n - 1]); // last object in KLambdaType is a K string of the lambda
     } else if (type == KAdverbType) {
         _kprint(OBJ_PTR(x)[0]);
-        printf("%c%s", "'/\\"[HDR_ARGC(x)%3], HDR_ARGC(x)>2 ? ":" : "");
+        kputc("'/\\"[HDR_ARGC(x)%3]);
+        if (HDR_ARGC(x) > 2) kputc(':');
     }
 }
 
-// write K object to stdout. public wrapper around recursive outr()
+// write K object to stdout, through the buffer (see kflush). public wrapper around recursive _kprint
 K kprint(K x){
     if (x == knull()) return x;
     _kprint(x);
-    putchar('\n');
+    kputc('\n');
     return UNREF_X(x);
 }
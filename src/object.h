@@ -5,7 +5,8 @@
 
 #define MIN_ALLOC 128UL // minimum bytes per object. size allows overreads (eg SIMD chunks)
 #define HDR_PAD    64UL
-#define BUCKET_SIZEOF(x) (MIN_ALLOC << HDR_BUCKET(x))  // size of the bucket that x is in
+#define MAPPED     255  // HDR_BUCKET of a list over a file mapping (see kmap), not in any bucket
+#define BUCKET_SIZEOF(x) (HDR_BUCKET(x) == MAPPED ? 0 : MIN_ALLOC << HDR_BUCKET(x))  // size of the bucket that x is in
 
 #define UNREF_X(k)  ({__typeof__(k)_k=(k); unref(x); _k;})
 #define UNREF_Y(k)  ({__typeof__(k)_k=(k); unref(y); _k;})
@@ -16,12 +17,14 @@
 K ref(K);
 void _unref(K);
 K syms4chrs(K);
-K_char addSym(K*, K_sym);
+K_int addSym(K*, K_sym);
 K* getSlot(K, K_sym);
 K_int findSym(K, K_sym);
 K _knew(K_char, K_int);
 K reuse(K_char, K);
 K knewcopy(K_char, K_int, K);
+K kcpy(K, K);
+K kmap(int, K_int);
 K k1(K);
 K k2(K, K);
 K k3(K, K, K);
@@ -42,6 +45,17 @@ K expand(K);
 K item(K_int, K);
 K promote(int, K);
 K kprint(K);
+void kwrite(const void*, size_t);
+void kflush(void);
+K_char *fmtInt(K_char*, K_long);
+
+// chars in i's decimal form, sign included. compares only, no branches: a pass over a list vectorizes
+static inline K_int intLen(K_long i){
+    uint64_t u = i < 0 ? -(uint64_t)i : (uint64_t)i, p = 10;
+    K_int n = 1 + (i < 0);
+    FOR(19) n += u >= p, p *= 10;
+    return n;
+}
 
 static inline K kchr(K_char c) { return TAG(KChrType, c); }
 static inline K kint(K_int  i) { return TAG(KIntType, i); }
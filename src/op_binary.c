@@ -8,6 +8,7 @@
 #include "sym.h"
 #include "utils.h"
 #include "error.h"
+#include "thread.h"
 
 // binary ops
 
@@ -17,7 +18,7 @@ K nyi(K x, K y){NYI_ERROR(1, "binary operator", unref(x);unref(y))}
 F2 binary_op[] = {nyi, add, sub, mul, nyi, min, max, ltn, mtn, eql, at, nyi, nyi, join, find, take, drop, match, nyi, cut};
 
 #define  ADD(x, y) ((x)+(y))
-//#define SUB(x, y) ((x)-(y)) // currently dead code
+#define  SUB(x, y) ((x)-(y)) // x-y goes through neg+add; used by -':
 #define  MUL(x, y) ((x)*(y))
 #define  EQL(x, y) ((x)==(y))
 #define BEQL(x, y) (~((x)^(y)))
@@ -93,13 +94,13 @@ F2 binary_op[] = {nyi, add, sub, mul, nyi, min, max, ltn, mtn, eql, at, nyi, nyi
 #define LA(V, E) { V *rp=(V*)r, *xp=(V*)x; V b=BCAST(V, y); K_int cn=(n+LANES(V)-1)/LANES(V); \
     for (K_int c=0; c<cn; c++) rp[c] = E(xp[c], b); }
 
-// dispatch LL-LA / BL-BA / CL-CA
-#define BY(   E) { if (IS_TAG(y)) BA(   E) else BL(   E); zeroBoolTail(r); }
-#define CY(V, E) { if (IS_TAG(y)) CA(V, E) else CL(V, E); zeroBoolTail(r); }
+// dispatch LL-LA / BL-BA / CL-CA. bool results get their tail zeroed after (see kernel)
+#define BY(   E) { if (IS_TAG(y)) BA(   E) else BL(   E); }
+#define CY(V, E) { if (IS_TAG(y)) CA(V, E) else CL(V, E); }
 #define LY(V, E) { if (IS_TAG(y)) LA(V, E) else LL(V, E) }
 
 #define LC(V) case 5:LY(V,VMIN);break; case 6:LY(V,VMAX);break; case 7:CY(V,LTN);break; case 8:CY(V,MTN);break; case 9:CY(V,EQL);break;
-#define LX(V) case 1:LY(V,ADD); break; case 3:LY(V,MUL); break; LC(V)
+#define LX(V) case 1:LY(V,ADD); break; case 2:LY(V,SUB); break; case 3:LY(V,MUL); break; LC(V)
 
 #define VSWITCH() \
     switch(t){ \
@@ -108,6 +109,25 @@ F2 binary_op[] = {nyi, add, sub, mul, nyi, min, max, ltn, mtn, eql, at, nyi, nyi
     case KIntType:  switch(op){LX(VI)} break; \
     case KLngType:  switch(op){case 9: CY(VJ,EQL); break;} break; }
 
+// VSWITCH over n items of x y into r. from parmin items it runs in PAR_CHUNK-item tasks on the pool (see par).
+// chunks are a multiple of every vector width and of 64 (bool words), so no vector straddles two tasks, even in place
+typedef struct { int op; K_char t; K x, y, r; K_int n; } Kernel;
+
+static void kernelTask(void *a, K_int c){
+    Kernel *p = a;
+    int op = p->op;
+    K_char t = p->t;
+    K_int lo = c*PAR_CHUNK, n = MIN(p->n - lo, (K_int)PAR_CHUNK);
+    K x = AT(t, p->x, lo), y = IS_TAG(p->y) ? p->y : AT(t, p->y, lo), r = AT(op < 7 ? t : KBoolType, p->r, lo);
+    VSWITCH();
+}
+
+static void kernel(int op, K_char t, K x, K y, K r, K_int n){
+    if (n < parmin){ VSWITCH(); }
+    else par((n + PAR_CHUNK-1) / PAR_CHUNK, kernelTask, &(Kernel){op, t, x, y, r, n});
+    if (HDR_TYPE(r) == KBoolType) zeroBoolTail(r);
+}
+
 static K binaryDispatch(int op, K x, K y){
     // first promote args to the wider type. binary ops work on same types. arith always promotes to int. comp promotes to max of args x,y
     K_char t = op < 5 ? KIntType : MAX(HDR_TYPE(x), IS_TAG(y) ? TAG_TYPE(y) : HDR_TYPE(y));
@@ -120,10 +140,99 @@ static K binaryDispatch(int op, K x, K y){
     K_int n = HDR_COUNT(x);
     // op 7-9 comparison, returns bool. op<7 arithmetic, x always promoted to int, and always returns int
     K r = op < 7 ? reuse(t, x) : knew(KBoolType, n);
-    VSWITCH();
+    kernel(op, t, x, y, r, n);
     return UNREF_XY(r);
 }
 
+// f':x and s f':x for atomic f on a typed list: the list-list kernels run x against x shifted back one item, then
+// item 0 is redone against the seed s. no seed (s=0): arith and min/max pass x[0] through, comparisons compare x[0]
+// with itself. ints and chrs shift by viewing x from x[-1] (unaligned; lane 0 of chunk 0 reads header bytes, fixed
+// up after), bools by shifting words. r is never x: chunk c+1 reads the last item of chunk c
+K prior(int op, K s, K x){
+    K_char t = op < 5 ? KIntType : HDR_TYPE(x);
+    if (!(x = promote(t, x))) return 0;
+    K_int n = HDR_COUNT(x);
+    K y = t == KBoolType ? knew(KBoolType, n) : x - WIDTH_OF(x);
+    if (t == KBoolType){
+        uint64_t *yp = (uint64_t*)y, *xp = (uint64_t*)x;
+        FOR_WORDS(x) yp[i] = xp[i] << 1 | (i ? xp[i-1] >> 63 : 0);
+    }
+    K r = knew(op < 7 ? t : KBoolType, n);
+    kernel(op, t, x, y, r, n);
+    if (n){
+        K a = item(0, x);
+        a = s ? binary_op[op](a, s) : op < 5 ? a : binary_op[op](a, a); // atoms: no refs to manage
+        switch (WIDTH_OF(r)){
+        case 0: CHR_PTR(r)[0] = (CHR_PTR(r)[0] & ~1) | TAG_VAL(a); break;
+        case 1: CHR_PTR(r)[0] = TAG_VAL(a); break;
+        case 4: INT_PTR(r)[0] = TAG_VAL(a); break;
+        }
+    }
+    if (t == KBoolType) unref(y);
+    return UNREF_X(r);
+}
+
+// op/x cmp y for op + & | (count, all, any) on typed lists, without the bitmap: each 64-item word of compare bits is
+// folded as soon as it's made, with bits past n masked off. & folds the inverted words as any, so & | stop at the
+// first nonzero word. PW takes a vector's compare mask; VW makes word c from up to 64/LANES(V) vectors, reading no
+// further than the vector holding item n-1
+#define PW(V, v) ((uint64_t)P##V(v) & (LANES(V) < 64 ? (1ULL << LANES(V) % 64) - 1 : -1ULL))
+#define VW(V, E, Y) ({ uint64_t _w = 0; K_int _k = 64/LANES(V), _cn = (n+LANES(V)-1)/LANES(V), _v = c*_k; \
+    if (_v + _k <= _cn) for (K_int i = 0; i < _k; i++, _v++) _w |= PW(V, E(xp[_v], Y)) << i*LANES(V); \
+    else for (K_int i = 0; _v < _cn; i++, _v++) _w |= PW(V, E(xp[_v], Y)) << i*LANES(V); _w; })
+#define FOLDW(W) { uint64_t inv = op == 5 ? -1ULL : 0, last = n % 64 ? (1ULL << n % 64) - 1 : -1ULL; \
+    for (K_int c = 0, wn = (n+63)/64; c < wn; c++){ uint64_t w = ((W) ^ inv) & (c+1 < wn ? -1ULL : last); \
+        if (op == 1) j += stdc_count_ones(w); else if (w){ j = 1; break; } } }
+
+#define RB(E)    { uint64_t *xp=(uint64_t*)x, *yp=(uint64_t*)y, b=TAG_VAL(y) ? -1ULL : 0; \
+    if (IS_TAG(y)) FOLDW(E(xp[c], b)) else FOLDW(E(xp[c], yp[c])) }
+#define RY(V, E) { V *xp=(V*)x; if (IS_TAG(y)){ V b=BCAST(V, y); FOLDW(VW(V, E, b)) } else { V *yp=(V*)y; FOLDW(VW(V, E, yp[_v])) } }
+#define RC(V) case 7:RY(V,LTN);break; case 8:RY(V,MTN);break; case 9:RY(V,EQL);break;
+
+// count (+) or any (& |, see FOLDW) of x cmp y over n items
+static K_int cmpFold(int op, int cmp, K_char t, K x, K y, K_int n){
+    K_int j = 0;
+    switch(t){
+    case KBoolType: switch(cmp){case 7:RB(BLTN);break; case 8:RB(BMTN);break; case 9:RB(BEQL);break;} break;
+    case KChrType:  switch(cmp){RC(VC)} break;
+    case KIntType:  switch(cmp){RC(VI)} break;
+    }
+    return j;
+}
+
+// from parmin items, chunks run as pool tasks (see par). chunks are whole words, so each masks only its own tail.
+// once a chunk decides & |, the chunks not yet started are skipped
+typedef struct { int op, cmp; K_char t; K x, y; K_int n, *part; bool done; } CmpFold;
+
+static void cmpFoldTask(void *a, K_int c){
+    CmpFold *p = a;
+    K_int lo = c*PAR_CHUNK;
+    if (p->op != 1 && __atomic_load_n(&p->done, __ATOMIC_RELAXED)){ p->part[c] = 0; return; }
+    p->part[c] = cmpFold(p->op, p->cmp, p->t, AT(p->t, p->x, lo), IS_TAG(p->y) ? p->y : AT(p->t, p->y, lo), MIN(p->n - lo, (K_int)PAR_CHUNK));
+    if (p->op != 1 && p->part[c]) __atomic_store_n(&p->done, 1, __ATOMIC_RELAXED);
+}
+
+// op/x cmp y (see OP_FOLD). anything but bool/chr/int lists against a same-length list or atom takes the long way
+K cmpOver(int op, int cmp, K x, K y){
+    if (IS_TAG(x) && !IS_TAG(y)){ K a = x; x = y, y = a; cmp = cmp == 7 ? 8 : cmp == 8 ? 7 : 9; }
+    if (IS_TAG(x) || !IS_VECTOR(x) || (IS_TAG(y) ? TAG_TYPE(y) - 1u > 2u : !IS_VECTOR(y) || HDR_COUNT(y) != HDR_COUNT(x))){
+        K r = binary_op[cmp](x, y), f = kadverb(kop(op), 1);
+        r = r ? adv1(f, r) : 0;
+        return unref(f), r;
+    }
+    K_char t = MAX(HDR_TYPE(x), IS_TAG(y) ? TAG_TYPE(y) : HDR_TYPE(y));
+    if (!IS_TAG(y) && !(y = promote(t, y))){ unref(x); return 0; }
+    if (!(x = promote(t, x))){ unref(y); return 0; }
+    K_int n = HDR_COUNT(x), j = 0, cn = (n + PAR_CHUNK-1) / PAR_CHUNK;
+    if (n < parmin) j = cmpFold(op, cmp, t, x, y, n);
+    else {
+        K_int part[cn];
+        par(cn, cmpFoldTask, &(CmpFold){op, cmp, t, x, y, n, part, 0});
+        FOR(cn) j = op == 1 ? j + part[i] : j | part[i];
+    }
+    return UNREF_XY(op == 1 ? kint(j) : TAG(KBoolType, op == 5 ? !j : j));
+}
+
 #define BINARY_OP(f,g,op) \
 K f(K x, K y){ \
     if (IS_TAG(x)){ \
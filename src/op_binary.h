@@ -22,5 +22,7 @@ K take(K, K);
 K drop(K, K);
 K match(K, K);
 K cut(K, K);
+K prior(int, K, K);
+K cmpOver(int, int, K, K);
 
 #endif
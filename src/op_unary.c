@@ -1,3 +1,5 @@
+#include <immintrin.h>
+
 #include "op_unary.h"
 #include "op_binary.h"
 #include "object.h"
@@ -6,11 +8,13 @@
 #include "file.h"
 #include "utils.h"
 #include "error.h"
+#include "sym.h"
+#include "thread.h"
 
 static K nyi1(K x){NYI_ERROR(1, "unary operator", unref(x);)}
 
 //               :     +     -    *      %     &      |     <     >     =     @     .      !    ,       ?     #      _     ~    $     ^    csv
-F1 unary_op[] = {nyi1, nyi1, neg, first, nyi1, where, nyi1, nyi1, nyi1, nyi1, nyi1, value, til, enlist, nyi1, count, nyi1, not, nyi1, nyi1, csv};
+F1 unary_op[] = {nyi1, nyi1, neg, first, nyi1, where, nyi1, nyi1, nyi1, nyi1, nyi1, value, til, enlist, nyi1, count, nyi1, not, string, nyi1, csv};
 
 // -x / neg x
 K neg(K x){
@@ -93,20 +97,99 @@ K not(K x){
     return HDR_TYPE(x) == 0 ? squeeze(_each1(not, x)) : KBoolType==HDR_TYPE(x) ? notBool(x) : eql(kint(0), x);
 }
 
-// 'csv' helper macro
-// uses locals of 'csv'
-#define PARSE_COL(KT, STORE, PARSE) do { \
-    K col = knew(KT, rows); \
-    K_int *p = idx + j; \
-    K_int prev = (h||j) ? *(p - 1) + 1 : 0; \
-    for (K_int i = 0; i < rows; i++){ \
-        STORE(col)[i] = PARSE(*p - prev, s + prev); \
-        p += cn; \
-        prev = *(p - 1) + 1; \
+// the decimal string of int i, at its exact size
+static K intStr(K_long i){
+    K r = knew(KChrType, intLen(i));
+    fmtInt(CHR_PTR(r), i);
+    return r;
+}
+
+// 'string' helper macro
+// uses locals of 'string'
+#define INT_STRS(PTR) do { \
+    FOR(n) s[i] = intLen(PTR(x)[i]); \
+    FOR(n){ \
+        K_int l = s[i]; \
+        s[i] = knew(KChrType, l); \
+        fmtInt(CHR_PTR(s[i]), PTR(x)[i]); \
     } \
-    OBJ_PTR(r)[rj++] = col; \
     } while(0)
 
+// $x / string x: an atom's text, and a list of them for a list. int strings are sized in a first pass over x, kept
+// in r's slots until each is allocated at its length and filled from the right: no scratch buffer, no copy. sym
+// strings are the sym table's own, so syms allocate nothing
+K string(K x){
+    if (IS_TAG(x)){
+        K_int t = TAG_TYPE(x), v = TAG_VAL(x);
+        TYPE_ERROR(!t || t > KSymType, "$x expects int, bool, char, sym or lists of them", );
+        return t == KIntType ? intStr(v) : t == KSymType ? symName(v) : kc1(t == KBoolType ? '0' + v : v);
+    }
+    K_int t = HDR_TYPE(x), n = HDR_COUNT(x);
+    if (t == KLambdaType) return UNREF_X(ref(OBJ_PTR(x)[HDR_COUNT(x) - 1]));
+    TYPE_ERROR(t > KSymType, "$x expects int, bool, char, sym or lists of them", unref(x));
+    if (!t) return _each1(string, x);
+    K r = knew(KObjType, n), *s = OBJ_PTR(r);
+    if (t == KIntType) INT_STRS(INT_PTR);
+    else if (t == KLngType) INT_STRS(LNG_PTR);
+    else if (t == KSymType) FOR(n) s[i] = symName(SYM_PTR(x)[i]);
+    else FOR(n) s[i] = kc1(t == KBoolType ? '0' + GET_BIT(x, i) : CHR_PTR(x)[i]);
+    return UNREF_X(r);
+}
+
+// cell ends (, or newline) in the 64 bytes of s at b, as a bit mask. a block past n is read from a zeroed copy
+static inline uint64_t cellEnds(K_char *s, K_long n, K_long b){
+    typedef K_char V __attribute__((vector_size(64), aligned(1)));
+    K_char t[64];
+    if (n - b < 64) memset(t, 0, 64), memcpy(t, s + b, n - b), s = t, b = 0;
+    V v = *(V*)(s + b), e = (V)((v == ',') | (v == '\n'));
+#ifdef __AVX512BW__
+    return _mm512_movepi8_mask((__m512i)e);
+#elif defined(__AVX2__)
+    __m256i *h = (__m256i*)&e;
+    return (uint32_t)_mm256_movemask_epi8(h[0]) | (uint64_t)(uint32_t)_mm256_movemask_epi8(h[1]) << 32;
+#else
+    uint64_t m = 0;
+    FOR(64) m |= (uint64_t)(e[i] & 1) << i;
+    return m;
+#endif
+}
+
+// csv data in chunks of size bytes, as pool tasks (see par). a first round counts each chunk's cells and finds its
+// last cell end. summed, the counts place each cell at its row and column, and the cell that ends first in a chunk
+// starts past the previous chunk's last end: so the second round parses chunks independently, straight into the
+// shared columns. head: the first row is the header, and isn't parsed
+typedef struct { K_char *s, *t; K *col; K_long n, size, *cells, *from; K_int cn, head; } Csv;
+
+static void countTask(void *a, K_int c){
+    Csv *p = a;
+    K_long lo = c*p->size, hi = MIN(p->n, lo + p->size), k = 0, last = -1;
+    for (K_long b = lo; b < hi; b += 64){
+        uint64_t m = cellEnds(p->s, p->n, b);
+        if (m) k += __builtin_popcountll(m), last = b + 63 - __builtin_clzll(m);
+    }
+    p->cells[c] = k, p->from[c] = last;
+}
+
+static void parseTask(void *a, K_int c){
+    Csv *p = a;
+    K_long lo = c*p->size, hi = MIN(p->n, lo + p->size), k = p->cells[c], prev = p->from[c];
+    K_int j = k % p->cn, row = k / p->cn - p->head;
+    for (K_long b = lo; b < hi; b += 64)
+        for (uint64_t m = cellEnds(p->s, p->n, b); m; m &= m - 1){
+            K_long e = b + __builtin_ctzll(m);
+            K_int l = e - prev;
+            K_char *s = p->s + prev;
+            K col = p->col[j];
+            if (row >= 0 && col) switch (p->t[j]){
+                case 'C': OBJ_PTR(col)[row] = kstr(l, s);    break;
+                case 'c': CHR_PTR(col)[row] = chr4chr(l, s); break;
+                case 'i': INT_PTR(col)[row] = int4chr(l, s); break;
+            }
+            prev = e + 1;
+            if (++j == p->cn) j = 0, row++;
+        }
+}
+
 K csv(K x){
     // first verify the argument
     TYPE_ERROR(IS_TAG(x) || HDR_TYPE(x) != KObjType || HDR_COUNT(x) != 3, 
@@ -141,30 +224,34 @@ K csv(K x){
         h = syms4chrs(cutStr(kstr(nl - s, s), ','));
         h = filter(1, h, eql(ref(t), kchr(' ')));
     }
-    // create list indices of separator and newlines (cell ends)
-    K sep = eql(kchr(','), ref(d));
-    K nwl = eql(kchr('\n'),ref(d));
-    K ind = where(max(sep, nwl));
-    PARSE_ERROR(HDR_COUNT(ind) % cn != 0, -1,
+    // two rounds over the data, 64 bytes at a time and from parmin bytes in PAR_CHUNK-byte chunks on the pool: count
+    // the cells to size the columns, then parse each cell into its column as its end turns up (see Csv). no index of
+    // cell ends is kept
+    K_long n = HDR_COUNT(d), size = n < parmin ? MAX(n, 1) : PAR_CHUNK;
+    K_int tasks = (n + size - 1) / size;
+    K chunks = knew(KLngType, 2*tasks); // per chunk: cells, from. on the heap, as tasks grows with the file
+    K_long *cells = LNG_PTR(chunks), *from = cells + tasks;
+    K col[cn];
+    Csv p = {s, CHR_PTR(t), col, n, size, cells, from, cn, !!h};
+    par(tasks, countTask, &p);
+    K_long total = 0, last = -1;
+    FOR(tasks){ // counts to cells before each chunk, last ends to each chunk's first cell start
+        K_long k = cells[i], e = from[i];
+        cells[i] = total, from[i] = last + 1;
+        total += k, last = e >= 0 ? e : last;
+    }
+    PARSE_ERROR(total % cn != 0, -1,
         "malformed csv. sep+nl % rows != 0", 
-        unref(x); unref(d); unref(h); unref(ind););
-    // loop and parse
-    K_int rows = HDR_COUNT(ind) / cn, *idx = INT_PTR(ind);
-    if (h) rows -= 1, idx += cn;
+        unref(x); unref(d); unref(h); unref(chunks););
+    K_int rows = total / cn - !!h;
     K r = knew(KObjType, rn);
-    // outer loop columns
-    K_int rj = 0; // used in PARSE_COL to advace return column count
-    for (K_int j = 0; j < cn; j++){
-        // inner strided loop column records
-        switch (CHR_PTR(t)[j]){
-        case ' ': /*skip this column*/ break;
-        case 'C': PARSE_COL(KObjType, OBJ_PTR, kstr);    break;
-        case 'c': PARSE_COL(KChrType, CHR_PTR, chr4chr); break;
-        case 'i': PARSE_COL(KIntType, INT_PTR, int4chr); break;
-        }
+    for (K_int j = 0, rj = 0; j < cn; j++){
+        K_char c = CHR_PTR(t)[j];
+        col[j] = c == ' ' ? 0 : (OBJ_PTR(r)[rj++] = knew(c == 'C' ? KObjType : c == 'c' ? KChrType : KIntType, rows));
     }
+    par(tasks, parseTask, &p);
     // cleanup
-    unref(d), unref(x), unref(ind);
+    unref(d), unref(x), unref(chunks);
     // TODO: table type
     return h ? k2(h, r) : r;
 }
@@ -13,6 +13,7 @@ K til(K);
 K enlist(K);
 K count(K);
 K not(K);
+K string(K);
 K csv(K);
 
 #endif
@@ -1,6 +1,10 @@
 #include "sym.h"
 #include "krua.h"
 #include "object.h"
+#include "thread.h"
+#include "eval.h"
+
+#include <pthread.h>
 
 // sym interning via separate-chain hash table
 // linear hash. aggressive growth policy: rebalance if appending a new entry to non-0-count chain
@@ -24,6 +28,7 @@ void initSymTab(){
 }
 
 void freeSymTab(){
+    uncacheLoads(); // cached bytecode names syms by id
     unref(SYMS), unref(HTAB);
 }
 
@@ -43,7 +48,7 @@ static void splitChain(){
 }
 
 // h = hashed sym. m = number of chains. maxsplit = split index bound: highest pow2 <= m, so split = m-maxsplit
-K_sym internSym(K_int n, K_char *s){
+static K_sym intern(K_int n, K_char *s){
     K_sym h = djb2(n, s);
     K_int m = HDR_COUNT(HTAB), maxsplit = stdc_bit_floor((K_sym)m), i = h & (2*maxsplit - 1);
     if (i >= m) i -= maxsplit;
@@ -61,3 +66,22 @@ K_sym internSym(K_int n, K_char *s){
     if (HDR_COUNT(chain) > 1) splitChain();
     return id;
 }
+
+// pool tasks (eg value"`a" in a parallel each) serialize on the table
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+K_sym internSym(K_int n, K_char *s){
+    if (!kworker) return intern(n, s);
+    pthread_mutex_lock(&lock);
+    K_sym r = intern(n, s);
+    pthread_mutex_unlock(&lock);
+    return r;
+}
+
+// the name of sym i: SYMS' own string, shared. under the same lock, as an intern may move SYMS
+K symName(K_sym i){
+    if (!kworker) return ref(OBJ_PTR(SYMS)[i]);
+    pthread_mutex_lock(&lock);
+    K r = ref(OBJ_PTR(SYMS)[i]);
+    pthread_mutex_unlock(&lock);
+    return r;
+}
@@ -9,5 +9,6 @@ extern K SYMS; // sym pool
 void initSymTab();
 void freeSymTab();
 K_sym internSym(K_int, K_char*);
+K symName(K_sym);
 
 #endif
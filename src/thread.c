@@ -0,0 +1,71 @@
+// worker pool: persistent threads, woken per job, pulling task indices off a shared counter
+// the main thread takes tasks too, and waits for every woken worker before returning, so no worker can
+// still be inside a job when the next one is posted. each thread allocates from its own buddy free lists (M is
+// thread-local) and has its own error state. nested par (a task calling par) runs serially
+
+#include <pthread.h>
+
+#include "thread.h"
+
+K_int nthreads = 1;
+_Thread_local bool kworker;
+K_int parmin = PAR_MIN;
+
+static pthread_t pool[THREADS_MAX];
+static pthread_mutex_t mu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t go = PTHREAD_COND_INITIALIZER, fin = PTHREAD_COND_INITIALIZER;
+static K_int spawned; // workers created. never shrinks; \p only changes how many are woken
+static struct {
+    void (*f)(void*, K_int);
+    void *ctx;
+    K_int n, w, active;
+    K_int next;     // next task index, claimed with atomic fetch-add
+    unsigned gen;   // bumped per job
+} job;
+
+static void run(void){
+    for (K_int i; (i = __atomic_fetch_add(&job.next, 1, __ATOMIC_RELAXED)) < job.n; ) job.f(job.ctx, i);
+}
+
+static void *worker(void *a){
+    K_int id = (K_int)(intptr_t)a;
+    unsigned seen = 0;
+    kworker = 1;
+    for (;;){
+        pthread_mutex_lock(&mu);
+        while (job.gen == seen || id >= job.w) seen = job.gen, pthread_cond_wait(&go, &mu);
+        seen = job.gen;
+        pthread_mutex_unlock(&mu);
+        run();
+        pthread_mutex_lock(&mu);
+        if (!--job.active) pthread_cond_signal(&fin);
+        pthread_mutex_unlock(&mu);
+    }
+    return 0;
+}
+
+// set the pool size (clamped to 1..THREADS_MAX), spawning workers as needed. returns the new size
+K_int threads(K_int n){
+    nthreads = MAX(1, MIN(n, THREADS_MAX));
+    for (; spawned < nthreads-1; spawned++)
+        if (pthread_create(pool + spawned, 0, worker, (void*)(intptr_t)spawned)){ nthreads = spawned+1; break; }
+    return nthreads;
+}
+
+// f(ctx, i) for i in 0..n-1 across the pool, in no particular order. returns when all are done
+void par(K_int n, void (*f)(void*, K_int), void *ctx){
+    if (nthreads < 2 || n < 2 || kworker){ FOR(n) f(ctx, i); return; }
+#ifdef TRACK_REFS
+    kworker = 1; FOR(n) f(ctx, i); kworker = 0; return; // the leak tracker isn't thread-safe: one thread, same rules
+#endif
+    pthread_mutex_lock(&mu);
+    job.f = f, job.ctx = ctx, job.n = n, job.next = 0;
+    job.active = job.w = MIN(n, nthreads) - 1;
+    job.gen++;
+    pthread_cond_broadcast(&go);
+    pthread_mutex_unlock(&mu);
+    kworker = 1, run(), kworker = 0;
+    pthread_mutex_lock(&mu);
+    while (job.active) pthread_cond_wait(&fin, &mu);
+    pthread_mutex_unlock(&mu);
+}
@@ -0,0 +1,16 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include "krua.h"
+
+extern K_int nthreads;              // pool size incl. the main thread. \p N sets it; 1 is serial
+extern _Thread_local bool kworker; // running a pool task: refcounts go atomic, globals are read-only
+extern K_int parmin;                // list kernels split into PAR_CHUNK-item pool tasks from this many items
+
+// item i of a t list, for chunking. bools: i must be a multiple of 8 (chunks are word-aligned)
+#define AT(t, x, i) ((x) + ((t) == KBoolType ? (i)/8 : (i)*KWIDTHS[t]))
+
+K_int threads(K_int);
+void par(K_int, void (*)(void*, K_int), void*);
+
+#endif